@@ -0,0 +1,108 @@
+#ifndef __BOUNDEDQUEUE_H__
+#define __BOUNDEDQUEUE_H__
+
+#include <vector>
+#include <algorithm>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread_time.hpp>
+
+namespace ASIOLib {
+	// what Push does with an item when the queue is full
+	enum FullQueuePolicy {
+		FQ_DROP_NEWEST,  // the item pushed is dropped
+		FQ_DROP_OLDEST,  // the oldest item queued is dropped to make room
+		FQ_BLOCK  // Push waits for room - the producer is slowed to the rate of the consumers
+	};
+
+	// A fixed-capacity FIFO between threads, preallocated as a ring so the queue itself never allocates - copying an
+	// item in or out still allocates if T's copy does, as a boost::function's of a bound string does.  The lock is
+	// only held to copy an item in or out, so a producer never waits on what the consumer does with an item, only
+	// (with FQ_BLOCK) for room.
+	template <typename T>
+	class BoundedQueue : private boost::noncopyable {
+		std::vector<T> _ring;
+		size_t _head, _depth;  // index of the oldest item, and number of items
+		const FullQueuePolicy _policy;
+		bool _stopped;
+		size_t _highWater;
+		unsigned long _dropped;
+		mutable boost::mutex _ringMutex;
+		boost::condition_variable _notEmpty, _notFull;
+
+		// with the lock held, and an item queued
+		void Take(T &item) {
+			std::swap(item, _ring[_head]);  // leaves the slot with the caller's previous item, to be overwritten
+			_head = (_head + 1) % _ring.size();
+			_depth--;
+			_notFull.notify_one();
+		}
+	public:
+		BoundedQueue(size_t capacity, FullQueuePolicy policy) :
+		  _ring(std::max<size_t>(capacity, 1)), _head(0), _depth(0), _policy(policy), _stopped(false), _highWater(0), _dropped(0) {}
+
+		// false if an item was dropped, or the queue has been stopped
+		bool Push(const T &item) {
+			boost::mutex::scoped_lock lock(_ringMutex);
+			if (_policy == FQ_BLOCK)
+				while (!_stopped && (_depth == _ring.size()))
+					_notFull.wait(lock);
+			if (_stopped)
+				return false;
+
+			bool dropped = false;
+			if (_depth == _ring.size()) {
+				_dropped++;
+				if (_policy == FQ_DROP_NEWEST)
+					return false;
+				_head = (_head + 1) % _ring.size();  // FQ_DROP_OLDEST - overwritten below
+				_depth--;
+				dropped = true;
+			}
+			_ring[(_head + _depth) % _ring.size()] = item;
+			_highWater = std::max(_highWater, ++_depth);
+			_notEmpty.notify_one();
+			return !dropped;
+		}
+
+		// waits for an item - false once the queue has been stopped and is empty
+		bool Pop(T &item) {
+			boost::mutex::scoped_lock lock(_ringMutex);
+			while (!_stopped && (_depth == 0))
+				_notEmpty.wait(lock);
+			if (_depth == 0)
+				return false;
+			Take(item);
+			return true;
+		}
+
+		// as above, but gives up after timeout - false if no item arrived in time, or the queue has been stopped and is empty
+		bool Pop(T &item, const boost::posix_time::time_duration &timeout) {
+			const boost::system_time until = boost::get_system_time() + timeout;
+			boost::mutex::scoped_lock lock(_ringMutex);
+			while (!_stopped && (_depth == 0))
+				if (!_notEmpty.timed_wait(lock, until))
+					break;
+			if (_depth == 0)
+				return false;
+			Take(item);
+			return true;
+		}
+
+		// wakes every waiting thread - pushes fail from now on, and pops drain what is left
+		void Stop() {
+			boost::mutex::scoped_lock lock(_ringMutex);
+			_stopped = true;
+			_notEmpty.notify_all();
+			_notFull.notify_all();
+		}
+
+		bool IsStopped() const { boost::mutex::scoped_lock lock(_ringMutex); return _stopped; }
+		size_t GetCapacity() const { return _ring.size(); }
+		size_t GetDepth() const { boost::mutex::scoped_lock lock(_ringMutex); return _depth; }
+		size_t GetHighWater() const { boost::mutex::scoped_lock lock(_ringMutex); return _highWater; }  // greatest depth so far
+		unsigned long GetDropped() const { boost::mutex::scoped_lock lock(_ringMutex); return _dropped; }
+	};
+}
+#endif
@@ -0,0 +1,80 @@
+#include "OutputSink.h"
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+
+namespace {
+	void WriteText(const std::string &text, std::ostream &out) {
+		out << text;
+	}
+
+	void WriteBytes(const std::vector<unsigned char> &bytes, std::ostream &out) {
+		out.write(reinterpret_cast<const char *>(&bytes[0]), bytes.size());
+	}
+}
+
+ASIOLib::OutputSink::OutputSink(std::ostream &out, size_t capacity, size_t flushSize, boost::posix_time::time_duration flushInterval,
+	FullQueuePolicy policy) :
+_out(out), _flushSize(flushSize), _flushInterval(flushInterval), _queue(capacity, policy) {
+	_writerThread = boost::thread(boost::bind(&OutputSink::WriterThread, this));
+}
+
+ASIOLib::OutputSink::~OutputSink() {
+	Stop();
+}
+
+void ASIOLib::OutputSink::WriterThread() {
+	// records are formatted into the buffer through a stream of its own, then the buffer is written to _out at once
+	std::string buffer;
+	buffer.reserve(_flushSize + _flushSize / 4);
+	boost::iostreams::stream<boost::iostreams::back_insert_device<std::string> > formatter(buffer);
+
+	// the interval runs from the last write, not from the last record, so a steady stream of records is still written
+	// out every flushInterval rather than only once the buffer fills
+	boost::system_time lastWrite = boost::get_system_time();
+	Record record;
+	while (true) {
+		const boost::posix_time::time_duration wait = buffer.empty() ? _flushInterval :
+			(lastWrite + _flushInterval) - boost::get_system_time();
+		bool popped = false;
+		if (buffer.empty() || (wait > boost::posix_time::time_duration(0, 0, 0))) {
+			popped = _queue.Pop(record, wait);
+			if (popped) {
+				record(formatter);
+				record.clear();
+				formatter.flush();
+				if (buffer.size() < _flushSize)
+					continue;
+			}
+		}
+		if (!buffer.empty()) {
+			_out.write(buffer.data(), buffer.size());
+			_out.flush();
+			buffer.clear();
+			lastWrite = boost::get_system_time();
+		}
+		if (!popped && _queue.IsStopped() && (_queue.GetDepth() == 0))
+			break;
+	}
+}
+
+bool ASIOLib::OutputSink::Submit(const Record &record) {
+	return _queue.Push(record);
+}
+
+bool ASIOLib::OutputSink::SubmitText(const std::string &text) {
+	return _queue.Push(boost::bind(&WriteText, text, _1));
+}
+
+bool ASIOLib::OutputSink::SubmitBytes(const unsigned char *bytes, size_t size) {
+	if (size == 0)
+		return true;
+	return _queue.Push(boost::bind(&WriteBytes, std::vector<unsigned char>(bytes, bytes + size), _1));
+}
+
+void ASIOLib::OutputSink::Stop() {
+	_queue.Stop();
+	if (_writerThread.joinable())
+		_writerThread.join();
+}
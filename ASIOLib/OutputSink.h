@@ -0,0 +1,44 @@
+#ifndef __OUTPUTSINK_H__
+#define __OUTPUTSINK_H__
+
+#include <string>
+#include <ostream>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include <boost/date_time.hpp>
+#include "BoundedQueue.h"
+#include "ASIOLib_Export.h"
+
+namespace ASIOLib {
+	// Output from any number of threads to one stream, written by a thread of its own.  A record is queued without
+	// waiting on the stream, and is only formatted on the sink's thread, into a buffer that is written out in one piece
+	// once it reaches flushSize, or flushInterval after the last write - never a line at a time.  Records may be text
+	// or binary, and are written in the order they were submitted.  A record submitted to a full queue is dropped and
+	// counted, unless the sink was created with FQ_BLOCK.
+	class ASIOLib_Export OutputSink : private boost::noncopyable {
+	public:
+		typedef boost::function<void (std::ostream &)> Record;  // writes itself to the stream it is given
+	private:
+		std::ostream &_out;
+		const size_t _flushSize;
+		const boost::posix_time::time_duration _flushInterval;
+		BoundedQueue<Record> _queue;
+		boost::thread _writerThread;
+
+		void WriterThread();
+	public:
+		OutputSink(std::ostream &out, size_t capacity = 8192, size_t flushSize = 64 * 1024,
+			boost::posix_time::time_duration flushInterval = boost::posix_time::milliseconds(100), FullQueuePolicy policy = FQ_DROP_NEWEST);
+		~OutputSink();
+
+		// false if the record was dropped
+		bool Submit(const Record &record);
+		bool SubmitText(const std::string &text);
+		bool SubmitBytes(const unsigned char *bytes, size_t size);
+
+		// writes out everything submitted so far and ends the thread - records submitted afterwards are dropped
+		void Stop();
+		unsigned long GetDropped() const { return _queue.GetDropped(); }
+	};
+}
+#endif
@@ -0,0 +1,52 @@
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <string>
+#include <boost/function.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace Benchmarks {
+	class Options {
+	public:
+		size_t _epochs;  // epochs of generated NMEA per run
+		size_t _count;  // items per run for benchmarks not driven by NMEA, such as coordinate kernels
+		unsigned int _threads;  // worker threads, where a benchmark uses them
+	};
+
+	typedef boost::function<void (const Options &)> BenchmarkFunction;
+	void Register(const std::string &name, const BenchmarkFunction &f);
+
+	// number of times operator new has been called by this process - only allocations made from the Benchmarks
+	// executable itself are seen on Windows, where each DLL has its own, so there link GPSLib statically to count them all
+	long GetAllocationCount();
+
+	// wall clock time and allocations from construction to Report()
+	class Measurement {
+		const boost::posix_time::ptime _start;
+		const long _startAllocations;
+	public:
+		Measurement() : _start(boost::posix_time::microsec_clock::universal_time()), _startAllocations(GetAllocationCount()) {}
+		// print name, count, count/sec, ns per item and allocations per item
+		void Report(const std::string &name, size_t count) const;
+	};
+
+	class Registrar {
+	public:
+		Registrar(const char *name, void (*f)(const Options &)) { Register(name, f); }
+	};
+}
+
+// the body follows the macro, so a benchmark that ignores its options can't say so itself
+#if defined(__GNUC__)
+#define BENCHMARK_UNUSED __attribute__((unused))
+#else
+#define BENCHMARK_UNUSED
+#endif
+
+// defines a benchmark, registered by name like a BOOST_AUTO_TEST_CASE, that is passed the command line Options
+#define BENCHMARK(name) \
+	static void name(const Benchmarks::Options &); \
+	static const Benchmarks::Registrar name##Registrar(#name, &name); \
+	static void name(const Benchmarks::Options &options BENCHMARK_UNUSED)
+
+#endif
@@ -0,0 +1,89 @@
+#include "Benchmark.h"
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <boost/thread.hpp>
+#include <boost/program_options.hpp>
+#include <boost/detail/atomic_count.hpp>
+
+namespace {
+	boost::detail::atomic_count allocations(0);
+
+	std::vector<std::pair<std::string, Benchmarks::BenchmarkFunction>> &GetBenchmarks() {
+		// in a function so it exists before the Registrars of other translation units use it
+		static std::vector<std::pair<std::string, Benchmarks::BenchmarkFunction>> benchmarks;
+		return benchmarks;
+	}
+}
+
+// count every allocation - the other forms of new and delete go through these
+void *operator new(std::size_t size) {
+	++allocations;
+	void *p = std::malloc(size ? size : 1);
+	if (p == 0)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void *p) throw() {
+	std::free(p);
+}
+
+void Benchmarks::Register(const std::string &name, const BenchmarkFunction &f) {
+	GetBenchmarks().push_back(std::make_pair(name, f));
+}
+
+long Benchmarks::GetAllocationCount() {
+	return allocations;
+}
+
+void Benchmarks::Measurement::Report(const std::string &name, size_t count) const {
+	const double seconds = (boost::posix_time::microsec_clock::universal_time() - _start).total_microseconds() / 1000000.0;
+	const long allocated = GetAllocationCount() - _startAllocations;
+	std::cout << std::left << std::setw(48) << name << std::right << std::fixed
+		<< std::setw(12) << count
+		<< std::setw(14) << std::setprecision(0) << ((seconds > 0) ? (count / seconds) : 0)
+		<< std::setw(12) << std::setprecision(1) << (count ? (seconds * 1e9 / count) : 0)
+		<< std::setw(12) << std::setprecision(2) << (count ? (static_cast<double>(allocated) / count) : 0)
+		<< std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+	Benchmarks::Options options;
+	std::string filter;
+	boost::program_options::options_description desc("Options");
+	desc.add_options()
+		("help,h", "help")
+		("list,l", "list benchmarks")
+		("filter,f", boost::program_options::value<std::string>(&filter), "only run benchmarks whose name contains this")
+		("epochs,n", boost::program_options::value<size_t>(&options._epochs)->default_value(10000), "epochs of generated NMEA per run")
+		("count,c", boost::program_options::value<size_t>(&options._count)->default_value(1000000), "items per run, for benchmarks not driven by NMEA")
+		("threads,t", boost::program_options::value<unsigned int>(&options._threads)->default_value(boost::thread::hardware_concurrency()), "worker threads")
+		;
+
+	boost::program_options::variables_map vm;
+	boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+	boost::program_options::notify(vm);
+
+	if (vm.count("help")) {
+		std::cout << desc << "\n";
+		return -1;
+	}
+
+	if (vm.count("list")) {
+		for (size_t i = 0; i < GetBenchmarks().size(); i++)
+			std::cout << GetBenchmarks()[i].first << std::endl;
+		return 0;
+	}
+
+	std::cout << std::left << std::setw(48) << "benchmark" << std::right << std::setw(12) << "count" << std::setw(14) << "per sec"
+		<< std::setw(12) << "ns each" << std::setw(12) << "allocs each" << std::endl;
+	for (size_t i = 0; i < GetBenchmarks().size(); i++)
+		if (filter.empty() || (GetBenchmarks()[i].first.find(filter) != std::string::npos))
+			GetBenchmarks()[i].second(options);
+
+	return 0;
+}
@@ -0,0 +1,187 @@
+#include "Benchmark.h"
+#include <map>
+#include <boost/thread.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include "../GPSLib/NMEAGenerator.h"
+#include "../GPSLib/GPSSentenceDecoder.h"
+
+namespace {
+	enum DecodeMode {
+		Posted,  // AddBytes posts through the decoder's strand, and the io_service is run once everything is added
+		PostedToWorkers,  // as Posted, but worker threads run the io_service while bytes are added, as the Executor does
+		Inline  // decoded inside AddBytes
+	};
+	const char *ModeNames[] = { "posted", "workers", "inline" };
+
+	enum Handlers {
+		Typed,  // the On* handlers with fully decoded fields, as GPSPublisher used to install
+		View  // OnSentence only
+	};
+
+	enum Stream {
+		Clean,
+		Noisy,  // a tenth of the sentences with bad checksums, and another tenth cut short
+		UBX  // the same epochs as UBX frames
+	};
+	const char *StreamNames[] = { "", "/noisy", "/ubx" };
+
+	// the same stream for every run of a given length, built once
+	const std::string &GetStream(size_t epochs, Stream stream) {
+		static std::map<std::pair<size_t, Stream>, std::string> streams;
+		std::string &s = streams[std::make_pair(epochs, stream)];
+		if (s.empty()) {
+			GPSLib::NMEAGenerator g(38.8048, -90.3070, 30.0, 45.0);
+			g.SetTurnRate(0.5);
+			if (stream == Noisy)
+				g.SetCorruption(0.1, 0.1);
+			s = (stream == UBX) ? g.GenerateUBX(epochs) : g.Generate(epochs);
+		}
+		return s;
+	}
+
+	void RunDecoder(const Benchmarks::Options &options, DecodeMode mode, Handlers handlers, size_t chunkSize, Stream stream = Clean) {
+		const std::string &s = GetStream(options._epochs, stream);
+		boost::asio::io_service ios;
+		const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder(GPSLib::SM_ALL, mode == Inline));  // so shared_from_this() will work
+		boost::detail::atomic_count decoded(0);  // counts rejected sentences too, so a noisy stream is comparable with a clean one
+		d->OnInvalidSentence = [&](boost::asio::io_service &, const std::string &) { ++decoded; };
+		if (handlers == Typed) {
+			d->OnGGA = [&](boost::asio::io_service &, boost::posix_time::time_duration, double, double, int, int, double, double) { ++decoded; };
+			d->OnGLL = [&](boost::asio::io_service &, boost::posix_time::time_duration, double, double, const std::string &) { ++decoded; };
+			d->OnRMC = [&](boost::asio::io_service &, boost::posix_time::time_duration, double, double, double, double, boost::gregorian::date, const std::string &) { ++decoded; };
+			d->OnGSV = [&](boost::asio::io_service &, int, int, int, const std::vector<GPSLib::SatelliteInfo> &) { ++decoded; };
+			d->OnGSA = [&](boost::asio::io_service &, const std::string &, int, const std::vector<int> &, double, double, double) { ++decoded; };
+		} else
+			d->OnSentence = [&](boost::asio::io_service &, const GPSLib::SentenceView &) { ++decoded; };
+
+		// bytes are handed over from one reused read buffer, as SerialPort does
+		std::vector<unsigned char> readBuffer(chunkSize);
+
+		const Benchmarks::Measurement m;
+		boost::scoped_ptr<boost::asio::io_service::work> work(mode == PostedToWorkers ? new boost::asio::io_service::work(ios) : 0);
+		boost::thread_group workerThreads;
+		if (mode == PostedToWorkers)
+			for (unsigned int i = 0; i < options._threads; ++i)
+				workerThreads.create_thread([&ios]() { ios.run(); });
+
+		for (size_t pos = 0; pos < s.size(); pos += chunkSize) {
+			const size_t n = std::min(chunkSize, s.size() - pos);
+			std::copy(s.begin() + pos, s.begin() + pos + n, readBuffer.begin());
+			d->AddBytes(ios, readBuffer, n);
+		}
+
+		work.reset();
+		if (mode == PostedToWorkers)
+			workerThreads.join_all();
+		else
+			ios.run();
+
+		m.Report(std::string("GPSSentenceDecoder/") + ModeNames[mode] + ((handlers == Typed) ? "/typed" : "/view") + StreamNames[stream] + "/chunk" +
+			boost::lexical_cast<std::string>(chunkSize), decoded + d->GetRejected(GPSLib::RR_TOO_LONG) + d->GetRejected(GPSLib::RR_TRUNCATED));
+	}
+
+	const size_t ChunkSizes[] = { 1, 16, 64, 512, 4096 };
+}
+
+BENCHMARK(DecoderChunkSizes) {
+	for (int mode = Posted; mode <= Inline; mode++)
+		for (size_t i = 0; i < sizeof(ChunkSizes) / sizeof(ChunkSizes[0]); i++)
+			RunDecoder(options, static_cast<DecodeMode>(mode), Typed, ChunkSizes[i]);
+}
+
+BENCHMARK(DecoderViewOnly) {
+	for (int mode = Posted; mode <= Inline; mode++)
+		RunDecoder(options, static_cast<DecodeMode>(mode), View, 512);
+}
+
+// the same epochs as binary UBX frames - counts are handler calls, so compare ns per epoch: 4 calls an epoch here, 7 for NMEA
+BENCHMARK(DecoderUBX) {
+	for (int mode = Posted; mode <= Inline; mode++)
+		RunDecoder(options, static_cast<DecodeMode>(mode), Typed, 512, UBX);
+}
+
+// should be close to DecoderChunkSizes at the same chunk size - rejecting a sentence costs no more than decoding one
+BENCHMARK(DecoderNoisy) {
+	for (int mode = Posted; mode <= Inline; mode++)
+		RunDecoder(options, static_cast<DecodeMode>(mode), Typed, 512, Noisy);
+}
+
+BENCHMARK(NMEAGenerator) {
+	const Benchmarks::Measurement m;
+	GPSLib::NMEAGenerator g(38.8048, -90.3070, 30.0, 45.0);
+	const std::string s(g.Generate(options._epochs));
+	m.Report("NMEAGenerator", g.GetSentenceCount());
+}
+
+// the UTC time of an RMC as GPSPublisher used to work it out, through the boost types, and from the decoder's date
+BENCHMARK(UTCTime) {
+	const std::string s("$GPRMC,191630.609,A,3848.2905,N,09018.4239,W,31.464734,56.21,150113,,*14\r\n");
+	boost::asio::io_service ios;
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder(GPSLib::SM_ALL, true));  // so shared_from_this() will work
+	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));  // sets the decoder's date
+	GPSLib::SentenceView view;
+	view.Parse(s.data(), s.data() + s.size());
+	boost::int64_t sum = 0;  // so the work isn't optimized away
+
+	{
+		const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+		const Benchmarks::Measurement m;
+		for (size_t i = 0; i < options._count; i++) {
+			boost::posix_time::time_duration time;
+			boost::gregorian::date date;
+			view.GetTime(GPSLib::RMCFields::Time, time);
+			view.GetDate(GPSLib::RMCFields::Date, date);
+			sum += (boost::posix_time::ptime(date, time) - epoch).total_milliseconds();
+		}
+		m.Report("UTCTime/ptime", options._count);
+	}
+
+	{
+		const Benchmarks::Measurement m;
+		for (size_t i = 0; i < options._count; i++) {
+			boost::int64_t utc;
+			d->GetUTCMilliseconds(view, GPSLib::RMCFields::Time, utc);
+			sum += utc;
+		}
+		m.Report("UTCTime/GetUTCMilliseconds", options._count);
+	}
+
+	if (sum == 0)
+		std::cout << std::endl;
+}
+
+BENCHMARK(LatLng) {
+	const std::string s("$GPRMC,191630.609,A,3848.2905,N,09018.4239,W,31.464734,56.21,150113,,*14\r\n");
+	GPSLib::SentenceView view;
+	view.Parse(s.data(), s.data() + s.size());
+
+	{
+		double sum = 0;  // so the work isn't optimized away
+		const Benchmarks::Measurement m;
+		for (size_t i = 0; i < options._count; i++) {
+			double latitude, longitude;
+			view.GetLatLng(GPSLib::RMCFields::Latitude, latitude);
+			view.GetLatLng(GPSLib::RMCFields::Longitude, longitude);
+			sum += latitude + longitude;
+		}
+		m.Report("LatLng/double", options._count);
+		if (sum == 0)
+			std::cout << std::endl;
+	}
+
+	{
+		boost::int64_t sum = 0;
+		const Benchmarks::Measurement m;
+		for (size_t i = 0; i < options._count; i++) {
+			GPSLib::FixedCoordinate latitude, longitude;
+			view.GetLatLng(GPSLib::RMCFields::Latitude, latitude);
+			view.GetLatLng(GPSLib::RMCFields::Longitude, longitude);
+			sum += latitude.GetValue() + longitude.GetValue();
+		}
+		m.Report("LatLng/FixedCoordinate", options._count);
+		if (sum == 0)
+			std::cout << std::endl;
+	}
+}
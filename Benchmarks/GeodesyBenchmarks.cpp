@@ -0,0 +1,141 @@
+#include "Benchmark.h"
+#include <vector>
+#include <iostream>
+#include "../GPSLib/Geodesy.h"
+#include "../GPSLib/Util.h"
+
+namespace {
+	// options._count fixes along a winding track, about 10m apart, with their NMEA ddmm.mmmm forms
+	class Track {
+	public:
+		std::vector<double> _lat, _lon, _height, _ddmm;
+		std::vector<char> _hemispheres;
+
+		explicit Track(size_t count) : _lat(count), _lon(count), _height(count), _ddmm(count), _hemispheres(count) {
+			for (size_t i = 0; i < count; i++) {
+				_lat[i] = 38.8048 + i * 0.00009 * std::cos(i * 0.001);
+				_lon[i] = -90.3070 + i * 0.00009 * std::sin(i * 0.001);
+				_height[i] = 132.0 + (i % 50);
+				const double degrees = static_cast<int>(std::fabs(_lon[i]));
+				_ddmm[i] = degrees * 100.0 + (std::fabs(_lon[i]) - degrees) * 60.0;
+				_hemispheres[i] = (_lon[i] < 0) ? 'W' : 'E';
+			}
+		}
+	};
+
+	// so the work isn't optimized away
+	void Consume(const std::vector<double> &v) {
+		double sum = 0;
+		for (size_t i = 0; i < v.size(); i++)
+			sum += v[i];
+		if (sum == 0)
+			std::cout << std::endl;
+	}
+}
+
+// each kernel against the loop of scalar calls it replaces
+BENCHMARK(Geodesy) {
+	const size_t n = options._count;
+	if (n < 2)
+		return;
+	const Track t(n);
+	std::vector<double> a(n), b(n), c(n);
+	std::vector<int> degrees(n), minutes(n), seconds(n);
+
+	{
+		const Benchmarks::Measurement m;
+		for (size_t i = 0; i < n; i++)
+			a[i] = GPSLib::NMEAToDecimalDegree(t._ddmm[i], t._hemispheres[i]);
+		m.Report("NMEAToDecimalDegrees/scalar", n);
+	}
+	{
+		const Benchmarks::Measurement m;
+		GPSLib::NMEAToDecimalDegrees(&t._ddmm[0], &t._hemispheres[0], &a[0], n);
+		m.Report("NMEAToDecimalDegrees/batch", n);
+	}
+	Consume(a);
+
+	{
+		const Benchmarks::Measurement m;
+		for (size_t i = 0; i < n; i++)
+			GPSLib::ToDegreesMinutesSeconds(t._lon[i], degrees[i], minutes[i], seconds[i]);
+		m.Report("ToDegreesMinutesSeconds/scalar", n);
+	}
+	{
+		const Benchmarks::Measurement m;
+		GPSLib::ToDegreesMinutesSeconds(&t._lon[0], &degrees[0], &minutes[0], &seconds[0], n);
+		m.Report("ToDegreesMinutesSeconds/batch", n);
+	}
+	if (seconds[n-1] == 60)
+		std::cout << std::endl;
+
+	{
+		const Benchmarks::Measurement m;
+		for (size_t i = 0; i + 1 < n; i++)
+			a[i] = GPSLib::HaversineDistance(t._lat[i], t._lon[i], t._lat[i+1], t._lon[i+1]);
+		m.Report("HaversineDistances/scalar", n-1);
+	}
+	{
+		const Benchmarks::Measurement m;
+		GPSLib::HaversineDistances(&t._lat[0], &t._lon[0], &t._lat[1], &t._lon[1], &a[0], n-1);
+		m.Report("HaversineDistances/batch", n-1);
+	}
+	{
+		const Benchmarks::Measurement m;
+		GPSLib::TrackDistances(&t._lat[0], &t._lon[0], &a[0], n);
+		m.Report("TrackDistances/batch", n-1);
+	}
+	Consume(a);
+
+	{
+		const Benchmarks::Measurement m;
+		for (size_t i = 0; i + 1 < n; i++)
+			a[i] = GPSLib::InitialBearing(t._lat[i], t._lon[i], t._lat[i+1], t._lon[i+1]);
+		m.Report("InitialBearings/scalar", n-1);
+	}
+	{
+		const Benchmarks::Measurement m;
+		GPSLib::InitialBearings(&t._lat[0], &t._lon[0], &t._lat[1], &t._lon[1], &a[0], n-1);
+		m.Report("InitialBearings/batch", n-1);
+	}
+	Consume(a);
+
+	{
+		const Benchmarks::Measurement m;
+		for (size_t i = 0; i + 1 < n; i++)
+			GPSLib::VincentyInverse(t._lat[i], t._lon[i], t._lat[i+1], t._lon[i+1], a[i], b[i]);
+		m.Report("VincentyInverse/scalar", n-1);
+	}
+	{
+		const Benchmarks::Measurement m;
+		GPSLib::VincentyInverse(&t._lat[0], &t._lon[0], &t._lat[1], &t._lon[1], &a[0], &b[0], n-1);
+		m.Report("VincentyInverse/batch", n-1);
+	}
+	Consume(a);
+
+	{
+		const Benchmarks::Measurement m;
+		for (size_t i = 0; i < n; i++)
+			GPSLib::GeodeticToECEF(t._lat[i], t._lon[i], t._height[i], a[i], b[i], c[i]);
+		m.Report("GeodeticToECEF/scalar", n);
+	}
+	{
+		const Benchmarks::Measurement m;
+		GPSLib::GeodeticToECEF(&t._lat[0], &t._lon[0], &t._height[0], &a[0], &b[0], &c[0], n);
+		m.Report("GeodeticToECEF/batch", n);
+	}
+	Consume(a);
+
+	{
+		const Benchmarks::Measurement m;
+		for (size_t i = 0; i < n; i++)
+			GPSLib::GeodeticToENU(t._lat[i], t._lon[i], t._height[i], t._lat[0], t._lon[0], t._height[0], a[i], b[i], c[i]);
+		m.Report("GeodeticToENU/scalar", n);
+	}
+	{
+		const Benchmarks::Measurement m;
+		GPSLib::GeodeticToENU(&t._lat[0], &t._lon[0], &t._height[0], t._lat[0], t._lon[0], t._height[0], &a[0], &b[0], &c[0], n);
+		m.Report("GeodeticToENU/batch", n);
+	}
+	Consume(a);
+}
@@ -0,0 +1,94 @@
+#include "Benchmark.h"
+#include <vector>
+#include <iostream>
+#include <boost/thread.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include "../GPSLib/LatestStateTable.h"
+
+namespace {
+	const size_t Sensors = 1000;
+
+	// what consumers have each built until now - a map behind a reader-writer lock
+	class LockedTable {
+		mutable boost::shared_mutex _mutex;
+		boost::unordered_map<std::string, GPSLib::SensorState> _states;
+	public:
+		void UpdatePosition(const std::string &sensorID, boost::uint64_t date, double latitude, double longitude) {
+			boost::unique_lock<boost::shared_mutex> lock(_mutex);
+			GPSLib::SensorState &state = _states[sensorID];
+			state._positionDate = date;
+			state._latitude = latitude;
+			state._longitude = longitude;
+		}
+
+		bool Get(const std::string &sensorID, GPSLib::SensorState &state) const {
+			boost::shared_lock<boost::shared_mutex> lock(_mutex);
+			const boost::unordered_map<std::string, GPSLib::SensorState>::const_iterator it = _states.find(sensorID);
+			if (it == _states.end())
+				return false;
+			state = it->second;
+			return true;
+		}
+	};
+
+	// one writer updating every sensor in turn, as fast as it can, while readers each make count lookups - reads
+	// are reported across all readers, and writes made meanwhile
+	template <typename TRead, typename TWrite>
+	void Contend(const std::string &name, unsigned int readers, size_t count, TRead read, TWrite write) {
+		volatile bool done = false;
+		size_t writes = 0;
+		boost::thread writer([&done, &writes, &write]() {
+			while (!done)
+				write(writes++);
+		});
+
+		const Benchmarks::Measurement m;
+		boost::thread_group readerThreads;
+		for (unsigned int r = 0; r < readers; r++)
+			readerThreads.create_thread([&read, count, r]() {
+				for (size_t i = 0; i < count; i++)
+					read(i * 7 + r);
+			});
+		readerThreads.join_all();
+		m.Report(name + "/" + boost::lexical_cast<std::string>(readers) + " readers", readers * count);
+
+		done = true;
+		writer.join();
+		if (writes == 0)
+			std::cout << std::endl;
+	}
+}
+
+// lookups of the latest state under a writer's constant updates, with the lock free table and a locked map, by id
+// and, for the table, by the handle Find returns
+BENCHMARK(LatestState) {
+	std::vector<std::string> ids;
+	for (size_t i = 0; i < Sensors; i++)
+		ids.push_back("sensor" + boost::lexical_cast<std::string>(i));
+	const size_t count = options._count / std::max(1u, options._threads);
+
+	GPSLib::LatestStateTable table;
+	LockedTable locked;
+	std::vector<size_t> handles;
+	for (size_t i = 0; i < Sensors; i++) {
+		table.UpdatePosition(ids[i], 0, 0, 0);
+		locked.UpdatePosition(ids[i], 0, 0, 0);
+		handles.push_back(table.Find(ids[i]));
+	}
+
+	// dates keep rising from run to run, or the table would skip every update as older than the last run's
+	boost::uint64_t date = 0;
+	for (unsigned int readers = 1; readers <= std::max(1u, options._threads); readers *= 2) {
+		Contend("LatestState/table by handle", readers, count,
+			[&](size_t i) { GPSLib::SensorState state; table.Get(handles[i % Sensors], state); },
+			[&](size_t i) { table.UpdatePosition(ids[i % Sensors], ++date, 38.8, -90.3); });
+		Contend("LatestState/table by id", readers, count,
+			[&](size_t i) { GPSLib::SensorState state; table.Get(ids[i % Sensors], state); },
+			[&](size_t i) { table.UpdatePosition(ids[i % Sensors], ++date, 38.8, -90.3); });
+		Contend("LatestState/locked map", readers, count,
+			[&](size_t i) { GPSLib::SensorState state; locked.Get(ids[i % Sensors], state); },
+			[&](size_t i) { locked.UpdatePosition(ids[i % Sensors], ++date, 38.8, -90.3); });
+	}
+}
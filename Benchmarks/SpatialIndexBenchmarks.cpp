@@ -0,0 +1,92 @@
+#include "Benchmark.h"
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <boost/lexical_cast.hpp>
+#include "../GPSLib/SpatialIndex.h"
+#include "../GPSLib/Geodesy.h"
+
+namespace {
+	const size_t Queries = 1000;
+
+	// sensors spread over about 100km square, as a city's fleet, each to be moved a few meters at a time
+	class Fleet {
+	public:
+		std::vector<std::string> _ids;
+		std::vector<double> _lat, _lon;
+
+		explicit Fleet(size_t count) {
+			std::srand(42);
+			for (size_t i = 0; i < count; i++) {
+				_ids.push_back("sensor" + boost::lexical_cast<std::string>(i));
+				_lat.push_back(38.8 + (std::rand() / static_cast<double>(RAND_MAX) - 0.5));
+				_lon.push_back(-90.3 + (std::rand() / static_cast<double>(RAND_MAX) - 0.5));
+			}
+		}
+	};
+
+	void Run(size_t sensors) {
+		const std::string suffix = "/" + boost::lexical_cast<std::string>(sensors);
+		const Fleet fleet(sensors);
+		GPSLib::SpatialIndex index;
+		{
+			const Benchmarks::Measurement m;
+			for (size_t i = 0; i < sensors; i++)
+				index.Update(fleet._ids[i], fleet._lat[i], fleet._lon[i]);
+			m.Report("SpatialIndex/add" + suffix, sensors);
+		}
+		{
+			// a second's movement of the whole fleet, some crossing cells
+			const Benchmarks::Measurement m;
+			for (size_t i = 0; i < sensors; i++)
+				index.Update(fleet._ids[i], fleet._lat[i] + 0.0001, fleet._lon[i] + 0.0001);
+			m.Report("SpatialIndex/update" + suffix, sensors);
+		}
+
+		size_t found = 0;
+		{
+			const Benchmarks::Measurement m;
+			for (size_t q = 0; q < Queries; q++) {
+				std::vector<GPSLib::SpatialMatch> matches;
+				index.InRadius(fleet._lat[q], fleet._lon[q], 500, matches);
+				found += matches.size();
+			}
+			m.Report("SpatialIndex/radius 500m" + suffix, Queries);
+		}
+		{
+			// what the index replaces
+			const Benchmarks::Measurement m;
+			for (size_t q = 0; q < Queries; q++)
+				for (size_t i = 0; i < sensors; i++)
+					if (GPSLib::HaversineDistance(fleet._lat[q], fleet._lon[q], fleet._lat[i] + 0.0001, fleet._lon[i] + 0.0001) <= 500)
+						found--;
+			m.Report("SpatialIndex/radius 500m scan" + suffix, Queries);
+		}
+		{
+			const Benchmarks::Measurement m;
+			for (size_t q = 0; q < Queries; q++) {
+				std::vector<GPSLib::SpatialMatch> matches;
+				index.InBox(fleet._lat[q] - 0.01, fleet._lon[q] - 0.01, fleet._lat[q] + 0.01, fleet._lon[q] + 0.01, matches);
+				found += matches.size();
+			}
+			m.Report("SpatialIndex/box 0.02deg" + suffix, Queries);
+		}
+		{
+			const Benchmarks::Measurement m;
+			for (size_t q = 0; q < Queries; q++) {
+				std::vector<GPSLib::SpatialMatch> matches;
+				index.Nearest(fleet._lat[q], fleet._lon[q], 10, matches);
+				found += matches.size();
+			}
+			m.Report("SpatialIndex/nearest 10" + suffix, Queries);
+		}
+		if (found == 0)
+			std::cout << std::endl;
+	}
+}
+
+// a fleet of 10k and one of 100k, queried a thousand times each way
+BENCHMARK(SpatialIndex) {
+	Run(10000);
+	Run(100000);
+}
@@ -0,0 +1,94 @@
+#ifndef __QOSPROFILES_H__
+#define __QOSPROFILES_H__
+
+#include <cstring>
+#include <string>
+#include <dds/DdsDcpsInfrastructureC.h>
+#include <dds/DdsDcpsPublicationC.h>
+#include <dds/DdsDcpsSubscriptionC.h>
+#include "DDSException.h"
+
+// Named sets of writer and reader QoS for the GPS topics, chosen with --qos in GPSPublisher and GPSSubscriber.  Both
+// sides must choose the same profile - a reliable reader doesn't match a best effort writer, nor a reader with a
+// shorter latency budget than its writer offers.
+//   default      the middleware's defaults, as before there were profiles
+//   low-latency  the streams (position, altitude, course and the fix) best effort, keeping only the latest sample,
+//                with no latency budget and a raised transport priority - satellite info and active satellites
+//                reliable, keeping the latest, at the normal priority
+//   reliable     every topic reliable, keeping the last ten samples
+// A latency budget or transport priority given on its own is set over the profile, the default one included, and
+// changes nothing else.
+class QosProfile {
+public:
+	bool _useDefaults;  // of the profile - the latency budget and transport priority may still be set over them
+	bool _setLatencyBudget, _setTransportPriority;
+	bool _reliableStreams, _reliableStatus;
+	CORBA::Long _streamDepth, _statusDepth;  // KEEP_LAST history depth
+	DDS::Duration_t _latencyBudget;
+	CORBA::Long _transportPriority;
+
+	QosProfile() : _useDefaults(true), _setLatencyBudget(false), _setTransportPriority(false), _reliableStreams(true), _reliableStatus(true), _streamDepth(1), _statusDepth(1),
+		_transportPriority(0) {
+		_latencyBudget.sec = 0;
+		_latencyBudget.nanosec = 0;
+	}
+
+	static QosProfile Get(const std::string &name) {
+		QosProfile profile;
+		if (name == "default")
+			return profile;
+
+		profile._useDefaults = false;
+		if (name == "low-latency") {
+			profile._reliableStreams = false;
+			profile._transportPriority = 10;
+		} else if (name == "reliable")
+			profile._streamDepth = profile._statusDepth = 10;
+		else
+			throw DDSException("unknown QoS profile - must be default, low-latency or reliable");
+		return profile;
+	}
+
+	void SetLatencyBudget(long milliseconds) {
+		_setLatencyBudget = true;
+		_latencyBudget.sec = milliseconds / 1000;
+		_latencyBudget.nanosec = (milliseconds % 1000) * 1000000;
+	}
+
+	void SetTransportPriority(long priority) {
+		_setTransportPriority = true;
+		_transportPriority = priority;
+	}
+
+	// position, altitude, course and the fix, in either form, sent every epoch - the others are the satellite status
+	static bool IsStream(const char *topicName) {
+		return (std::strcmp(topicName, "GPS_SatelliteInfo") != 0) && (std::strcmp(topicName, "GPS_ActiveSatellites") != 0);
+	}
+
+	template <typename TQos>
+	void ApplyCommon(const char *topicName, TQos &qos) const {
+		const bool stream = IsStream(topicName);
+		qos.reliability.kind = (stream ? _reliableStreams : _reliableStatus) ? DDS::RELIABLE_RELIABILITY_QOS : DDS::BEST_EFFORT_RELIABILITY_QOS;
+		qos.history.kind = DDS::KEEP_LAST_HISTORY_QOS;
+		qos.history.depth = stream ? _streamDepth : _statusDepth;
+	}
+
+	void Apply(const char *topicName, DDS::DataWriterQos &qos) const {
+		if (!_useDefaults) {
+			ApplyCommon(topicName, qos);
+			qos.transport_priority.value = IsStream(topicName) ? _transportPriority : 0;
+		} else if (_setTransportPriority && IsStream(topicName))
+			qos.transport_priority.value = _transportPriority;
+		if (!_useDefaults || _setLatencyBudget)
+			qos.latency_budget.duration = _latencyBudget;
+	}
+
+	void Apply(const char *topicName, DDS::DataReaderQos &qos) const {
+		if (!_useDefaults)
+			ApplyCommon(topicName, qos);
+		if (!_useDefaults || _setLatencyBudget)
+			qos.latency_budget.duration = _latencyBudget;
+	}
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef __CHARCLASS_H__
+#define __CHARCLASS_H__
+
+#include <boost/preprocessor/repetition/enum.hpp>
+
+namespace GPSLib {
+	// character classes of the NMEA text, independent of the locale
+	enum CharClassBits {
+		CC_DIGIT = 0x01,  // 0-9
+		CC_HEX = 0x02,  // 0-9, A-F, a-f
+		CC_NMEA = 0x04  // can appear in a sentence - printable ASCII, CR and LF
+	};
+
+	// 256-entry tables indexed by byte value, generated by the preprocessor so they are initialized data rather than
+	// built at startup.  A class template so the header can define them once for every module that includes it.
+	template <typename T> class CharTables {
+	public:
+		static const signed char _hexValue[256];  // -1 if not a hex digit
+		static const signed char _digitValue[256];  // -1 if not a decimal digit
+		static const unsigned char _class[256];  // CharClassBits
+	};
+
+#define GPSLIB_DIGIT_VALUE(z, c, data) (((c) >= '0') && ((c) <= '9') ? (c) - '0' : -1)
+#define GPSLIB_HEX_VALUE(z, c, data) \
+	(((c) >= '0') && ((c) <= '9') ? (c) - '0' : ((c) >= 'A') && ((c) <= 'F') ? (c) - 'A' + 10 : ((c) >= 'a') && ((c) <= 'f') ? (c) - 'a' + 10 : -1)
+#define GPSLIB_CHAR_CLASS(z, c, data) ( \
+	((((c) >= '0') && ((c) <= '9')) ? CC_DIGIT : 0) | \
+	((GPSLIB_HEX_VALUE(z, c, data) >= 0) ? CC_HEX : 0) | \
+	(((((c) >= 0x20) && ((c) <= 0x7E)) || ((c) == '\r') || ((c) == '\n')) ? CC_NMEA : 0))
+
+	template <typename T> const signed char CharTables<T>::_hexValue[256] = { BOOST_PP_ENUM(256, GPSLIB_HEX_VALUE, ~) };
+	template <typename T> const signed char CharTables<T>::_digitValue[256] = { BOOST_PP_ENUM(256, GPSLIB_DIGIT_VALUE, ~) };
+	template <typename T> const unsigned char CharTables<T>::_class[256] = { BOOST_PP_ENUM(256, GPSLIB_CHAR_CLASS, ~) };
+
+#undef GPSLIB_CHAR_CLASS
+#undef GPSLIB_HEX_VALUE
+#undef GPSLIB_DIGIT_VALUE
+
+	// chars convert to their byte value
+	inline int HexValue(unsigned char c) { return CharTables<void>::_hexValue[c]; }
+	inline int DigitValue(unsigned char c) { return CharTables<void>::_digitValue[c]; }
+	inline bool IsDigit(unsigned char c) { return (CharTables<void>::_class[c] & CC_DIGIT) != 0; }
+	inline bool IsNMEAChar(unsigned char c) { return (CharTables<void>::_class[c] & CC_NMEA) != 0; }
+}
+#endif
@@ -0,0 +1,126 @@
+#ifndef __CONFLATOR_H__
+#define __CONFLATOR_H__
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/date_time.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/enable_shared_from_this.hpp>
+
+namespace GPSLib {
+	// when the values of a topic are published - the default publishes every value as it arrives
+	class PublishPolicy {
+	public:
+		boost::posix_time::time_duration _interval;  // at most one value per key per interval, the latest - not_a_date_time for no limit
+		double _deadband;  // a value that has changed by less than this since the last one published isn't published, in the units of the Change function
+
+		PublishPolicy(boost::posix_time::time_duration interval = boost::posix_time::time_duration(boost::posix_time::not_a_date_time),
+			double deadband = 0) : _interval(interval), _deadband(deadband) {}
+	};
+
+	// Keeps only the latest value of each key between flushes, and publishes it if it has changed by at least the
+	// deadband since the last value published for its key.  With an interval, Start runs a timer on ios that flushes
+	// once per interval - without one, each value is checked and published as it is added.  Values may be added from
+	// any thread.  Like the decoder, a conflator with an interval must be managed by a shared_ptr, as the timer holds a
+	// reference to it.
+	template <typename TKey, typename TValue>
+	class Conflator : private boost::noncopyable, public boost::enable_shared_from_this<Conflator<TKey, TValue> > {
+		class Entry {
+		public:
+			TValue _latest, _published;
+			bool _pending, _havePublished;
+			Entry() : _pending(false), _havePublished(false) {}
+		};
+
+		const PublishPolicy _policy;
+		boost::mutex _entriesMutex;
+		std::map<TKey, Entry> _entries;
+		boost::asio::deadline_timer _timer;
+		unsigned long _published, _conflated, _suppressed;
+
+		typedef std::vector<std::pair<TKey, TValue> > Publications;
+
+		// with the lock held - the value is only handed to OnPublish once the lock has been released
+		bool Publish(Entry &entry) {
+			entry._pending = false;
+			if (entry._havePublished && Change && (Change(entry._published, entry._latest) < _policy._deadband)) {
+				_suppressed++;
+				return false;
+			}
+			entry._published = entry._latest;
+			entry._havePublished = true;
+			_published++;
+			return true;
+		}
+
+		void Tick(const boost::system::error_code &ec) {
+			if (ec == boost::asio::error::operation_aborted)
+				return;
+			Flush();
+			// from the last expiry rather than now, so a late tick doesn't drift the cadence
+			_timer.expires_at(_timer.expires_at() + _policy._interval);
+			_timer.async_wait(boost::bind(&Conflator::Tick, this->shared_from_this(), boost::asio::placeholders::error));
+		}
+	public:
+		Conflator(boost::asio::io_service &ios, const PublishPolicy &policy) :
+		  _policy(policy), _timer(ios), _published(0), _conflated(0), _suppressed(0) {}
+
+		void Start() {
+			if (_policy._interval.is_special())
+				return;
+			_timer.expires_from_now(_policy._interval);
+			_timer.async_wait(boost::bind(&Conflator::Tick, this->shared_from_this(), boost::asio::placeholders::error));
+		}
+
+		void Stop() {
+			boost::system::error_code ec;
+			_timer.cancel(ec);
+		}
+
+		void Add(const TKey &key, const TValue &value) {
+			bool publish = false;
+			{
+				boost::mutex::scoped_lock lock(_entriesMutex);
+				Entry &entry = _entries[key];
+				if (entry._pending)
+					_conflated++;  // replaces one that was never published
+				entry._latest = value;
+				entry._pending = true;
+				if (_policy._interval.is_special())
+					publish = Publish(entry);
+			}
+			if (publish && OnPublish)
+				OnPublish(key, value);
+		}
+
+		// publish the latest value of every key added to since the last flush
+		void Flush() {
+			Publications publications;
+			{
+				boost::mutex::scoped_lock lock(_entriesMutex);
+				for (typename std::map<TKey, Entry>::iterator it = _entries.begin(); it != _entries.end(); ++it)
+					if (it->second._pending && Publish(it->second))
+						publications.push_back(std::make_pair(it->first, it->second._published));
+			}
+			if (OnPublish)
+				for (typename Publications::const_iterator it = publications.begin(); it != publications.end(); ++it)
+					OnPublish(it->first, it->second);
+		}
+
+		unsigned long GetPublished() const { return _published; }
+		unsigned long GetConflated() const { return _conflated; }  // replaced by a newer value before a flush
+		unsigned long GetSuppressed() const { return _suppressed; }  // within the deadband of the last value published
+
+		// how far apart the last value published and a new one are, compared with the deadband - if not set, every
+		// value is far enough
+		boost::function<double (const TValue &, const TValue &)> Change;
+		// called once the conflator's lock has been released, so may wait - on a full queue, say - without holding up
+		// Add on other threads.  Values of a key added from more than one thread at once may reach it out of order.
+		boost::function<void (const TKey &, const TValue &)> OnPublish;
+	};
+}
+#endif
@@ -0,0 +1,122 @@
+#include "EpochFixAssembler.h"
+#include <boost/bind.hpp>
+
+namespace {
+	const unsigned int TimedSentences = GPSLib::SM_GGA | GPSLib::SM_RMC;  // sentences that carry the time of the epoch
+}
+
+GPSLib::EpochFixAssembler::EpochFixAssembler(boost::asio::io_service &ios, unsigned int requiredSentences,
+	boost::posix_time::time_duration timeout, bool emitIncomplete) :
+_requiredSentences(requiredSentences), _timeout(timeout), _emitIncomplete(emitIncomplete), _haveEmitted(false),
+	_timer(ios), _completeFixes(0), _incompleteFixes(0), _droppedFixes(0) {}
+
+bool GPSLib::EpochFixAssembler::BeginSentence(boost::asio::io_service &ios, boost::posix_time::time_duration time) {
+	if (_haveEmitted && (time == _lastEmittedTime))
+		return false;  // a late sentence for an epoch that has already been emitted
+
+	if ((_fix._sentences & TimedSentences) && (_fix._time != time))
+		Emit(ios, false);  // superseded by a newer epoch
+
+	if (!(_fix._sentences & TimedSentences)) {
+		_fix._time = time;
+		if (!_timeout.is_special()) {
+			// restarting the timer cancels the wait for the previous epoch
+			_timer.expires_from_now(_timeout);
+			_timer.async_wait(boost::bind(&EpochFixAssembler::Timeout, shared_from_this(), boost::ref(ios), time, boost::asio::placeholders::error));
+		}
+	}
+	return true;
+}
+
+void GPSLib::EpochFixAssembler::EndSentence(boost::asio::io_service &ios, unsigned int sentence) {
+	_fix._sentences |= sentence;
+	if (Now)
+		_fix._received = Now();
+	if ((_fix._sentences & TimedSentences) && ((_fix._sentences & _requiredSentences) == _requiredSentences))
+		Emit(ios, true);
+}
+
+void GPSLib::EpochFixAssembler::Emit(boost::asio::io_service &ios, bool complete) {
+	const bool emit = complete || (_emitIncomplete && (_fix._sentences & TimedSentences));
+	if (complete)
+		_completeFixes++;
+	else if (emit)
+		_incompleteFixes++;
+	else
+		_droppedFixes++;
+
+	if (emit) {
+		_haveEmitted = true;
+		_lastEmittedTime = _fix._time;
+		if (OnFix)
+			OnFix(ios, _fix);
+	}
+
+	_fix.Clear();
+	boost::system::error_code ec;
+	_timer.cancel(ec);
+}
+
+void GPSLib::EpochFixAssembler::Timeout(boost::asio::io_service &ios, boost::posix_time::time_duration time, const boost::system::error_code &ec) {
+	if (ec == boost::asio::error::operation_aborted)
+		return;
+
+	boost::mutex::scoped_lock lock(_fixMutex);
+	if ((_fix._sentences & TimedSentences) && (_fix._time == time))
+		Emit(ios, false);
+}
+
+void GPSLib::EpochFixAssembler::AddGGA(boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude,
+	int quality, int numSatellites, double horizontalDilution, double altitude) {
+	boost::mutex::scoped_lock lock(_fixMutex);
+	if (!BeginSentence(ios, time))
+		return;
+
+	_fix._latitude = latitude;
+	_fix._longitude = longitude;
+	_fix._altitude = altitude;
+	_fix._quality = quality;
+	_fix._numSatellites = numSatellites;
+	if (!(_fix._sentences & SM_GSA))
+		_fix._hdop = horizontalDilution;  // GSA has all three DOPs, so prefer it
+	_fix._valid |= (quality != 0);
+	EndSentence(ios, SM_GGA);
+}
+
+void GPSLib::EpochFixAssembler::AddRMC(boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude,
+	double speed, double course, boost::gregorian::date date, const std::string &validity) {
+	boost::mutex::scoped_lock lock(_fixMutex);
+	if (!BeginSentence(ios, time))
+		return;
+
+	if (!(_fix._sentences & SM_GGA)) {
+		// GGA has the same position, plus altitude, so prefer it
+		_fix._latitude = latitude;
+		_fix._longitude = longitude;
+	}
+	_fix._speed = speed;
+	_fix._course = course;
+	_fix._date = date;
+	_fix._valid |= (validity == "A");
+	EndSentence(ios, SM_RMC);
+}
+
+void GPSLib::EpochFixAssembler::AddGSA(boost::asio::io_service &ios, const std::string &/*mode*/, int fix, const std::vector<int> &satellitesInView,
+	double pdop, double hdop, double vdop) {
+	boost::mutex::scoped_lock lock(_fixMutex);
+	// with no epoch in progress there is no time to place the GSA with yet, so it is held for the next epoch
+	_fix._fixMode = fix;
+	_fix._activeSatellites.assign(satellitesInView.begin(), satellitesInView.end());
+	_fix._pdop = pdop;
+	_fix._hdop = hdop;
+	_fix._vdop = vdop;
+	EndSentence(ios, SM_GSA);
+}
+
+void GPSLib::EpochFixAssembler::Flush(boost::asio::io_service &ios) {
+	boost::mutex::scoped_lock lock(_fixMutex);
+	if (_fix._sentences & TimedSentences)
+		Emit(ios, false);
+	else
+		_fix.Clear();  // drop a held GSA
+}
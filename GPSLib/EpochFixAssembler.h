@@ -0,0 +1,87 @@
+#ifndef __EPOCHFIXASSEMBLER_H__
+#define __EPOCHFIXASSEMBLER_H__
+
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/function.hpp>
+#include <boost/date_time.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include "SentenceView.h"
+#include "GPSLib_Export.h"
+
+namespace GPSLib {
+	// everything a receiver reports about one UTC second (epoch), merged from the sentences sent for it
+	class EpochFix {
+	public:
+		unsigned int _sentences;  // SentenceMask bits of the sentences merged into the fix
+		boost::posix_time::time_duration _time;
+		boost::gregorian::date _date;  // not_a_date_time until an RMC has been seen
+		double _latitude, _longitude, _altitude;
+		double _speed, _course;  // knots, degrees
+		double _pdop, _hdop, _vdop;
+		int _quality, _numSatellites, _fixMode;  // GGA quality, GGA satellites used, GSA fix (1=none, 2=2D, 3=3D)
+		bool _valid;  // GGA quality is non-zero or RMC validity is A
+		std::vector<int> _activeSatellites;
+		boost::posix_time::ptime _received;  // the assembler's Now as the latest sentence was merged in - not_a_date_time without one
+
+		EpochFix() { _activeSatellites.reserve(12); Clear(); }
+		void Clear() {
+			_sentences = SM_NONE;
+			_time = boost::posix_time::time_duration();
+			_date = boost::gregorian::date();
+			_latitude = _longitude = _altitude = _speed = _course = _pdop = _hdop = _vdop = 0;
+			_quality = _numSatellites = 0;
+			_fixMode = 1;
+			_valid = false;
+			_activeSatellites.clear();
+			_received = boost::posix_time::ptime();
+		}
+	};
+
+	// Groups decoded GGA, RMC and GSA sentences by their UTC time, and emits one merged EpochFix per epoch as
+	// soon as every sentence in requiredSentences has been seen.  GSA carries no time, so it joins the epoch in
+	// progress, or the next one to start.  An epoch that is superseded by a newer one, or is still incomplete
+	// when timeout expires, is emitted as is if emitIncomplete is set and it has a position, else dropped.
+	// The Add* methods take the same arguments as the matching GPSSentenceDecoder handlers.  Like the decoder,
+	// the assembler must be managed by a shared_ptr, as the timeout holds a reference to it.
+	class GPSLib_Export EpochFixAssembler : private boost::noncopyable, public boost::enable_shared_from_this<EpochFixAssembler> {
+		const unsigned int _requiredSentences;
+		const boost::posix_time::time_duration _timeout;
+		const bool _emitIncomplete;
+		boost::mutex _fixMutex;
+		EpochFix _fix;
+		bool _haveEmitted;
+		boost::posix_time::time_duration _lastEmittedTime;
+		boost::asio::deadline_timer _timer;
+		unsigned long _completeFixes, _incompleteFixes, _droppedFixes;
+
+		bool BeginSentence(boost::asio::io_service &ios, boost::posix_time::time_duration time);
+		void EndSentence(boost::asio::io_service &ios, unsigned int sentence);
+		void Emit(boost::asio::io_service &ios, bool complete);
+		void Timeout(boost::asio::io_service &ios, boost::posix_time::time_duration time, const boost::system::error_code &ec);
+	public:
+		EpochFixAssembler(boost::asio::io_service &ios, unsigned int requiredSentences = SM_GGA | SM_RMC | SM_GSA,
+			boost::posix_time::time_duration timeout = boost::posix_time::seconds(1), bool emitIncomplete = true);
+
+		void AddGGA(boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude, int quality,
+			int numSatellites, double horizontalDilution, double altitude);
+		void AddRMC(boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude,
+			double speed, double course, boost::gregorian::date date, const std::string &validity);
+		void AddGSA(boost::asio::io_service &ios, const std::string &mode, int fix, const std::vector<int> &satellitesInView,
+			double pdop, double hdop, double vdop);
+		void Flush(boost::asio::io_service &ios);  // emit (or drop) the epoch in progress now
+
+		unsigned long GetCompleteFixes() const { return _completeFixes; }
+		unsigned long GetIncompleteFixes() const { return _incompleteFixes; }
+		unsigned long GetDroppedFixes() const { return _droppedFixes; }
+
+		// when each sentence is merged in, for EpochFix::_received - an epoch superseded by a newer one is emitted as
+		// the newer one's first sentence is added, so the time then would be too late for it
+		boost::function<boost::posix_time::ptime ()> Now;
+		// called with the assembler locked, so must not call back into it - the fix is only valid during the call
+		boost::function<void (boost::asio::io_service &, const EpochFix &)> OnFix;
+	};
+}
+#endif
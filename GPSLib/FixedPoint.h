@@ -0,0 +1,37 @@
+#ifndef __FIXEDPOINT_H__
+#define __FIXEDPOINT_H__
+
+#include <cmath>
+#include <boost/cstdint.hpp>
+
+namespace GPSLib {
+	// A latitude or longitude as a whole number of 1e-7 degrees - about a centimeter, and the unit UBX NAV-PVT uses.
+	// Half the size of a double, and can be produced straight from the sentence text by SentenceView::GetLatLng.  An
+	// NMEA coordinate has at most five decimals of minutes (1.7e-7 degree), so it is held to within half a unit.
+	class FixedCoordinate {
+		boost::int32_t _value;
+	public:
+		enum { Scale = 10000000 };  // units per degree
+
+		FixedCoordinate() : _value(0) {}
+		explicit FixedCoordinate(boost::int32_t value) : _value(value) {}
+
+		// rounded to the nearest unit
+		static FixedCoordinate FromDegrees(double degrees) {
+			return FixedCoordinate(static_cast<boost::int32_t>(std::floor(degrees * Scale + 0.5)));
+		}
+
+		boost::int32_t GetValue() const { return _value; }
+		double GetDegrees() const { return _value / static_cast<double>(Scale); }
+
+		bool operator==(const FixedCoordinate &other) const { return _value == other._value; }
+		bool operator!=(const FixedCoordinate &other) const { return _value != other._value; }
+	};
+
+	// a measurement such as altitude or speed as a whole number of 10^-decimals, rounded to the nearest - the units
+	// SentenceView::GetScaled reads from the text
+	inline boost::int32_t ToScaled(double value, int decimals) {
+		return static_cast<boost::int32_t>(std::floor(value * std::pow(10.0, decimals) + 0.5));
+	}
+}
+#endif
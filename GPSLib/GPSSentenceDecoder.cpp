@@ -1,223 +1,335 @@
 #include "GPSSentenceDecoder.h"
 #include "Util.h"
-#include <cctype>
 #include <boost/bind.hpp>
-#include <boost/tokenizer.hpp> 
-#include <boost/regex.hpp>
 
-void GPSLib::GPSSentenceDecoder::AddBytes(boost::asio::io_service &ios, const std::vector<unsigned char> &bufferToAdd, size_t bufferSize) {
-	boost::mutex::scoped_lock lock(_bufferMutex);
+namespace {
+	const int MillisecondsPerDay = 24 * 60 * 60 * 1000;
+}
 
-	if (_decodeStrand == 0)
-		_decodeStrand = boost::shared_ptr<boost::asio::strand>(new boost::asio::strand(ios));
+GPSLib::GPSSentenceDecoder::GPSSentenceDecoder(unsigned int sentenceMask, bool decodeInline) :
+_sentenceMask(sentenceMask), _decodeInline(decodeInline), _ubxFixType(0), _dayStart(-1), _dayStartTimeOfDay(0) {
+	_ubxDOP._gdop = _ubxDOP._pdop = _ubxDOP._tdop = _ubxDOP._vdop = _ubxDOP._hdop = _ubxDOP._ndop = _ubxDOP._edop = 0;
+	std::fill(_rejected, _rejected + RR_COUNT, 0);
+}
 
-	// pass bufferSize in case buffer has size greater than the amount of meaningful data in it
-	std::for_each(bufferToAdd.begin(), (bufferSize == -1) ? bufferToAdd.end() : (bufferToAdd.begin() + bufferSize), [this](const unsigned char &c) {
-		if (std::isprint(c) || (c=='\r') || (c == '\n'))  // a sentence is ASCII plus CR-LF - ignore anything out of that range
-			_buffer += c;
-	});
+unsigned int GPSLib::GPSSentenceDecoder::GetWantedSentences() const {
+	if (_sentenceMask != SM_INSTALLED_HANDLERS)
+		return _sentenceMask;
+	return OnSentence ? SM_ALL : GetInstalledHandlers();
+}
 
-	size_t pos;
-	while ( (pos = _buffer.find("\r\n")) != std::string::npos) {  // tokenize on \r\n which ends a string
-		const std::string s(_buffer.substr(0, pos+2));  // +2 for \r\n
-		_buffer.erase(0, pos+2);
-		// post this to io_service through a strand to keep order of decode the same as order of arrival (as some messages may decode faster than others)
-		_decodeStrand->post(boost::bind(&GPSSentenceDecoder::Decode, shared_from_this(), boost::ref(ios), s));  
-	}
+unsigned int GPSLib::GPSSentenceDecoder::GetInstalledHandlers() const {
+	unsigned int mask = SM_NONE;
+	if (OnGGA) mask |= SM_GGA;
+	if (OnGLL) mask |= SM_GLL;
+	if (OnRMC) mask |= SM_RMC;
+	if (OnGSV) mask |= SM_GSV;
+	if (OnGSA) mask |= SM_GSA;
+	return mask;
 }
 
+void GPSLib::GPSSentenceDecoder::SetDate(int daysSinceEpoch, int millisecondsOfDay) {
+	_dayStart = static_cast<boost::int64_t>(daysSinceEpoch) * MillisecondsPerDay;
+	_dayStartTimeOfDay = millisecondsOfDay;
+}
 
-namespace {
-	bool TokenizeSentence(const std::string &s, std::vector<std::string> &tokens) {
-		tokens.clear();
-		const std::string::size_type dollarPos = s.find("$");
-		const std::string::size_type CRLFPos = s.find("\r\n");
-
-		// fail if can't find sentence boundary, or sentence too short
-		if ((dollarPos == std::string::npos) ||
-			(CRLFPos == std::string::npos) ||
-			(CRLFPos - dollarPos < 5)) {
-				return false;
-		}
+bool GPSLib::GPSSentenceDecoder::GetUTCMilliseconds(int millisecondsOfDay, boost::int64_t &value) const {
+	if (_dayStart < 0)
+		return false;
+	value = _dayStart + millisecondsOfDay;
+	if (millisecondsOfDay < _dayStartTimeOfDay - MillisecondsPerDay/2)
+		value += MillisecondsPerDay;  // past midnight, ahead of the RMC with the new date
+	else if (millisecondsOfDay > _dayStartTimeOfDay + MillisecondsPerDay/2)
+		value -= MillisecondsPerDay;  // before midnight, behind the RMC with the new date
+	return true;
+}
 
-		std::string::size_type textEndPos = CRLFPos;
-		const std::string::size_type starPos = s.rfind("*");
-		if (starPos != std::string::npos) {
-			// have a checksum, so validate it
-			const char expected_checksum_bytes[] = { s[starPos+1], s[starPos+2], 0 };  // checksum is just prior to the CRLF
-			const unsigned char expected_checksum = boost::lexical_cast<GPSLib::byte_from_hex>(expected_checksum_bytes);
+bool GPSLib::GPSSentenceDecoder::GetUTCMilliseconds(const SentenceView &view, size_t timeField, boost::int64_t &value) const {
+	int millisecondsOfDay;
+	return view.GetTimeOfDay(timeField, millisecondsOfDay) && GetUTCMilliseconds(millisecondsOfDay, value);
+}
 
-			unsigned char calculated_checksum = 0;
-			std::for_each(s.begin()+dollarPos+1, s.begin()+starPos, [&calculated_checksum](char c) { calculated_checksum^=c; });  // +1, since only chars between $ *
+unsigned long GPSLib::GPSSentenceDecoder::GetRejected(RejectReason reason) const {
+	boost::mutex::scoped_lock lock(_rejectedMutex);
+	return _rejected[reason];
+}
 
-			// fail if checksum mismatch
-			if (calculated_checksum != expected_checksum)
-				return false;
+void GPSLib::GPSSentenceDecoder::Reject(RejectReason reason) {
+	// counted from both AddBytes and the decode strand
+	boost::mutex::scoped_lock lock(_rejectedMutex);
+	_rejected[reason]++;
+}
 
-			textEndPos = starPos;
-		}
+void GPSLib::GPSSentenceDecoder::Reject(boost::asio::io_service &ios, RejectReason reason, const std::string &s) {
+	Reject(reason);
+	if (OnInvalidSentence) 
+		OnInvalidSentence(ios, s);
+}
 
-		// only tokenize from char following $ to before *, if it exists
-		const boost::char_separator<char> sep(",", 0, boost::keep_empty_tokens);
-		const boost::tokenizer<boost::char_separator<char>> t(s.begin()+dollarPos, s.begin()+textEndPos, sep);
-		std::copy(t.begin(), t.end(), std::back_inserter(tokens));
-		return tokens.size()>0;  // parse is good if there is at least one token
-	}
+void GPSLib::GPSSentenceDecoder::AddBytes(boost::asio::io_service &ios, const std::vector<unsigned char> &bufferToAdd, size_t bufferSize) {
+	boost::mutex::scoped_lock lock(_bufferMutex);
+
+	if (!_decodeInline && (_decodeStrand == 0))
+		_decodeStrand = boost::shared_ptr<boost::asio::strand>(new boost::asio::strand(ios));
+
+	const unsigned int wantedSentences = GetWantedSentences();
 
-	const boost::regex hms("(\\d{2})(\\d{2})(\\d{2})(?:(.\\d*))?");
-	boost::posix_time::time_duration DecodeTime(std::vector<std::string>::iterator &i) {
-		boost::smatch m;
-		if (boost::regex_match(*i, m, hms)) {
-			i++;  // consume the match
-			const boost::posix_time::hours hr(boost::lexical_cast<int>(m[1].str()));
-			const boost::posix_time::minutes min(boost::lexical_cast<int>(m[2].str()));
-			const boost::posix_time::seconds sec(boost::lexical_cast<int>(m[3].str()));
-			const boost::posix_time::milliseconds ms(boost::lexical_cast<int>(boost::lexical_cast<double>(m[4].str())*1000));
-			return boost::posix_time::time_duration(hr+min+sec+ms);
+	// pass bufferSize in case buffer has size greater than the amount of meaningful data in it
+	std::for_each(bufferToAdd.begin(), (bufferSize == -1) ? bufferToAdd.end() : (bufferToAdd.begin() + bufferSize), [&](const unsigned char &c) {
+		// binary UBX frames come between sentences - a sync char is never part of a sentence, so a frame can start anywhere
+		if (_ubxFramer.IsFraming() || (c == UBXFramer::Sync1)) {
+			const UBXFramer::Result result = _ubxFramer.Add(c);
+			if (result == UBXFramer::Complete) {
+				const std::vector<unsigned char> frame(_ubxFramer.GetFrame(), _ubxFramer.GetFrame() + _ubxFramer.GetLength());
+				if (_decodeInline)
+					DecodeUBX(ios, frame);
+				else
+					_decodeStrand->post(boost::bind(&GPSSentenceDecoder::DecodeUBX, shared_from_this(), boost::ref(ios), frame));
+			} else if (result == UBXFramer::Invalid)
+				Reject(RR_UBX_INVALID);
+			if (result != UBXFramer::NotUBX)
+				return;
+			// otherwise the sync char was noise, and c is taken as text
 		}
-		else
-			throw std::invalid_argument(*i + " is not hms");
-	}
 
-	const boost::regex latlng("(\\d{2,3})(\\d{2}.\\d+)");
-	double DecodeLatLng(std::vector<std::string>::iterator &i) {
-		boost::smatch m;
-		if (boost::regex_match(*i, m, latlng)) {
-			i++; // consume the match
-			double deg = boost::lexical_cast<double>(m[1].str());
-			double min = boost::lexical_cast<double>(m[2].str());
-			std::string hemisphere = *i++;
-			return GPSLib::ToDecimalDegree(deg, min, hemisphere);
+		switch (_framer.Add(c, wantedSentences)) {
+		case SentenceFramer::Complete: {
+			const std::string sentence(_framer.GetSentence(), _framer.GetLength());
+			if (_decodeInline)
+				Decode(ios, sentence);
+			else  // post this to io_service through a strand to keep order of decode the same as order of arrival (as some messages may decode faster than others)
+				_decodeStrand->post(boost::bind(&GPSSentenceDecoder::Decode, shared_from_this(), boost::ref(ios), sentence));
+			break;
 		}
-		else
-			throw std::invalid_argument(*i + " is not lat or lng");
+		case SentenceFramer::TooLong:
+			Reject(RR_TOO_LONG);
+			break;
+		case SentenceFramer::Truncated:
+			Reject(RR_TRUNCATED);
+			break;
+		default:
+			break;
+		}
+	});
+}
+
+
+namespace {
+	// value of an optional numeric field, or def if it is empty or malformed
+	int GetInt(const GPSLib::SentenceView &view, size_t field, int def) {
+		int value = def;
+		view.GetInt(field, value);
+		return value;
 	}
 
-	const boost::regex dmy("(\\d{2})(\\d{2})(\\d{2})");
-	boost::gregorian::date DecodeDate(std::vector<std::string>::iterator &i) {
-		boost::smatch m;
-		if (boost::regex_match(*i, m, dmy)) {
-			i++; // consume the match
-			int day = boost::lexical_cast<int>(m[1].str());
-			int month = boost::lexical_cast<int>(m[2].str());
-			int year = boost::lexical_cast<int>(m[3].str()) + 2000;
-			return boost::gregorian::date(year, month, day);
-		}
-		else
-			throw std::invalid_argument(*i + " is not dmy");
+	double GetDouble(const GPSLib::SentenceView &view, size_t field, double def) {
+		double value = def;
+		view.GetDouble(field, value);
+		return value;
+	}
+
+	std::string GetString(const GPSLib::SentenceView &view, size_t field) {
+		std::string value;
+		view.GetString(field, value);
+		return value;
 	}
 }
 
 void GPSLib::GPSSentenceDecoder::Decode(boost::asio::io_service &ios, const std::string &s) {
-	try {
-		std::vector<std::string> v;
-		if (!TokenizeSentence(s, v)) {
-			if (OnInvalidSentence) 
-				OnInvalidSentence(ios, s);
+	SentenceView view;
+	RejectReason reason;
+	if (!view.Parse(s.data(), s.data() + s.size(), reason)) {
+		Reject(ios, reason, s);
+		return;
+	}
+
+	if (view.GetType() == SM_RMC) {
+		// keep the date for GetUTCMilliseconds(), ahead of the callbacks that use it
+		int daysSinceEpoch, millisecondsOfDay;
+		if (view.GetDaysSinceEpoch(RMCFields::Date, daysSinceEpoch) && view.GetTimeOfDay(RMCFields::Time, millisecondsOfDay))
+			SetDate(daysSinceEpoch, millisecondsOfDay);
+	}
+
+	if (OnSentence)
+		OnSentence(ios, view);
+
+	// the remaining handlers take fully decoded fields, so only pay for the decode if the handler is installed
+	if ((view.GetType() != SM_NONE) && !(view.GetType() & GetInstalledHandlers()))
+		return;
+
+	// time, position and date are required - the other fields default when empty
+	if (view.GetType() == SM_GGA) {
+		// GGA = Global Positioning System Fix Data
+		// $GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*48
+		boost::posix_time::time_duration time;
+		double lat, lng;
+		if (!view.GetTime(GGAFields::Time, time) || !view.GetLatLng(GGAFields::Latitude, lat) || !view.GetLatLng(GGAFields::Longitude, lng)) {
+			Reject(ios, RR_BAD_FIELD, s);
 			return;
 		}
+		const int quality = GetInt(view, GGAFields::Quality, 0);
+		const int numSatellites = GetInt(view, GGAFields::NumSatellites, 0);
+		const double horizontalDilution = GetDouble(view, GGAFields::HorizontalDilution, 0);
+		const double altitude = GetDouble(view, GGAFields::Altitude, 0);
+
+		if (OnGGA)
+			OnGGA(ios, time, lat, lng, quality, numSatellites, horizontalDilution, altitude);
+		return;
+	}
 
-		std::vector<std::string>::iterator i = v.begin();
-		if (*i == "$GPGGA") {
-			// GGA = Global Positioning System Fix Data
-			// $GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*48
-			i++;  // consume the $GPGGA token
-			const boost::posix_time::time_duration time(DecodeTime(i));
-			const double lat = DecodeLatLng(i);
-			const double lng = DecodeLatLng(i);
-			const int quality = lexical_cast_default<int>(*i++, 0);
-			const int numSatellites = lexical_cast_default<int>(*i++, 0);
-			const double horizontalDilution = lexical_cast_default<double>(*i++, 0);
-			const double altitude = lexical_cast_default<double>(*i++, 0);
-
-			if (OnGGA)
-				OnGGA(ios, time, lat, lng, quality, numSatellites, horizontalDilution, altitude);
+
+	if (view.GetType() == SM_GLL) {
+		// GLL = Geographic Position, Latitude / Longitude and time
+		// $GPGLL,3848.2905,N,09018.4239,W,191630.609,A*20
+		boost::posix_time::time_duration time;
+		double lat, lng;
+		if (!view.GetLatLng(GLLFields::Latitude, lat) || !view.GetLatLng(GLLFields::Longitude, lng) || !view.GetTime(GLLFields::Time, time)) {
+			Reject(ios, RR_BAD_FIELD, s);
 			return;
 		}
+		const std::string validity(GetString(view, GLLFields::Validity));
 
+		if (OnGLL)
+			OnGLL(ios, time, lat, lng, validity);
+		return;
+	}
 
-		if (*i == "$GPGLL") {
-			// GLL = Geographic Position, Latitude / Longitude and time
-			// $GPGLL,3848.2905,N,09018.4239,W,191630.609,A*20
-			i++;  // consume the $GPGLL token
-			double lat = DecodeLatLng(i);
-			double lng = DecodeLatLng(i);
-			boost::posix_time::time_duration time(DecodeTime(i));
-			std::string validity(*i++);
 
-			if (OnGLL)
-				OnGLL(ios, time, lat, lng, validity);
+	if (view.GetType() == SM_RMC) {
+		// RMC = Recommended minimum specific GPS/Transit data 
+		// $GPRMC,191632.609,A,3848.3005,N,09018.4051,W,32.523475,55.89,150113,,*14
+		boost::posix_time::time_duration time;
+		double lat, lng;
+		boost::gregorian::date date;
+		if (!view.GetTime(RMCFields::Time, time) || !view.GetLatLng(RMCFields::Latitude, lat) || !view.GetLatLng(RMCFields::Longitude, lng) ||
+			!view.GetDate(RMCFields::Date, date)) {
+			Reject(ios, RR_BAD_FIELD, s);
 			return;
 		}
+		const std::string validity(GetString(view, RMCFields::Validity));
+		const double speed = GetDouble(view, RMCFields::Speed, 0);  // knots
+		const double course = GetDouble(view, RMCFields::Course, 0);
 
+		if (OnRMC)
+			OnRMC(ios, time, lat, lng, speed, course, date, validity);
+		return;
+	}
 
-		if (*i == "$GPRMC") {
-			// RMC = Recommended minimum specific GPS/Transit data 
-			// $GPRMC,191632.609,A,3848.3005,N,09018.4051,W,32.523475,55.89,150113,,*14
-			i++;  // consume the $GPRMC token
-			boost::posix_time::time_duration time(DecodeTime(i));
-			std::string validity(*i++);
-			double lat = DecodeLatLng(i);
-			double lng = DecodeLatLng(i);
-			double speed = lexical_cast_default<double>(*i++, 0);  // knots
-			double course = lexical_cast_default<double>(*i++, 0);
-			boost::gregorian::date date(DecodeDate(i));
-
-			if (OnRMC)
-				OnRMC(ios, time, lat, lng, speed, course, date, validity);
-			return;
+
+	if (view.GetType() == SM_GSV) {
+		// GSV = GPS Satellites in view
+		// $GPGSV,3,1,10,18,62,311,37,15,47,49,40,14,16,218,30,29,11,186,28*4A
+		const int totalMessages = GetInt(view, GSVFields::TotalMessages, 0);
+		const int messageNumber = GetInt(view, GSVFields::MessageNumber, 0);
+		const int totalSatellitesInView = GetInt(view, GSVFields::TotalSatellitesInView, 0);
+		std::vector<SatelliteInfo> satelliteInfo;
+		for (size_t field = GSVFields::FirstSatellite; field < view.GetNumFields(); field += 4)
+			satelliteInfo.push_back(SatelliteInfo(GetInt(view, field, 0), GetInt(view, field+1, 0), GetInt(view, field+2, 0), GetInt(view, field+3, 0)));
+
+		if (OnGSV)
+			OnGSV(ios, totalMessages, messageNumber, totalSatellitesInView, satelliteInfo);
+		return;
+	}
+
+
+	if (view.GetType() == SM_GSA) {
+		// GSA = GPS DOP and active satellites
+		// $GPGSA,A,3,18,15,21,06,09,,,,,,,,3.7,2.8,2.3*3C
+		const std::string mode(GetString(view, GSAFields::Mode));
+		const int fix = GetInt(view, GSAFields::Fix, 1);  // 1=fix not available
+		std::vector<int> satellitesInView;
+		for (size_t field = GSAFields::FirstSatellite; field < GSAFields::PDOP; field++) {
+			const int sv = GetInt(view, field, -1);
+			if (sv != -1)
+				satellitesInView.push_back(sv);
 		}
+		const double pdop = GetDouble(view, GSAFields::PDOP, 0);
+		const double hdop = GetDouble(view, GSAFields::HDOP, 0);
+		const double vdop = GetDouble(view, GSAFields::VDOP, 0);
+
+		if (OnGSA)
+			OnGSA(ios, mode, fix, satellitesInView, pdop, hdop, vdop);
+		return;
+	}
+
+	// didn't parse anything
+	Reject(ios, RR_UNKNOWN_TYPE, s);
+}
+
+void GPSLib::GPSSentenceDecoder::DecodeUBX(boost::asio::io_service &ios, const std::vector<unsigned char> &frame) {
+	if (OnUBX)
+		OnUBX(ios, frame);
+
+	const unsigned char messageClass = frame[2], messageId = frame[3];
+	const unsigned char *payload = &frame[UBXFramer::HeaderLength];
+	const size_t payloadLength = frame.size() - UBXFramer::HeaderLength - UBXFramer::ChecksumLength;
+	if (messageClass != UBX_NAV)
+		return;
+	const unsigned int wantedSentences = GetWantedSentences();
+
+	if (messageId == UBX_NAV_DOP) {
+		DecodeNavDOP(payload, payloadLength, _ubxDOP);
+		return;
+	}
 
 
-		if (*i == "$GPGSV") {
-			// GSV = GPS Satellites in view
-			// $GPGSV,3,1,10,18,62,311,37,15,47,49,40,14,16,218,30,29,11,186,28*4A
-			i++;  // consume the $GPGSV token
-			int totalMessages = lexical_cast_default<int>(*i++, 0);
-			int messageNumber = lexical_cast_default<int>(*i++, 0);
-			int totalSatellitesInView = lexical_cast_default<int>(*i++, 0);
-			std::vector<SatelliteInfo> satelliteInfo;
-			while (i!=v.end()) {
-				int prn = lexical_cast_default<int>(*i++, 0);
-				int elevation = lexical_cast_default<int>(*i++, 0);
-				int azimuth = lexical_cast_default<int>(*i++, 0);
-				int snr = lexical_cast_default<int>(*i++, 0);
-				satelliteInfo.push_back(SatelliteInfo(prn, elevation, azimuth, snr));
-			}
-
-			if (OnGSV)
-				OnGSV(ios, totalMessages, messageNumber, totalSatellitesInView, satelliteInfo);
+	if (messageId == UBX_NAV_PVT) {
+		UBXNavPVT pvt;
+		if (!DecodeNavPVT(payload, payloadLength, pvt)) {
+			Reject(RR_BAD_FIELD);  // an impossible date or time, which would otherwise throw building it below
 			return;
 		}
+		_ubxFixType = pvt._fixType;
+		// without a valid time the UTC is the receiver's guess, so it neither sets the date nor stamps a valid fix
+		const bool validDate = (pvt._valid & 0x01) != 0, validTime = (pvt._valid & 0x02) != 0;
+		if (validDate && validTime)
+			SetDate(DaysSinceEpoch(pvt._year, pvt._month, pvt._day), ((pvt._hour*60 + pvt._minute)*60 + pvt._second)*1000);
+
+		const boost::posix_time::time_duration time(boost::posix_time::hours(pvt._hour) + boost::posix_time::minutes(pvt._minute) +
+			boost::posix_time::seconds(pvt._second) + boost::posix_time::milliseconds(pvt._nano / 1000000));
+		const bool gnssFixOK = (pvt._flags & 0x01) != 0;
+
+		if (OnGGA && (wantedSentences & SM_GGA)) {
+			// GGA quality: 0 invalid, 1 GPS fix, 2 differential fix, 6 estimated (dead reckoning)
+			int quality = 0;
+			if (validTime && (pvt._fixType == 1))
+				quality = 6;
+			else if (validTime && gnssFixOK && (pvt._fixType >= 2) && (pvt._fixType <= 4))
+				quality = (pvt._flags & 0x02) ? 2 : 1;
+			OnGGA(ios, time, pvt._latitude, pvt._longitude, quality, pvt._numSatellites, _ubxDOP._hdop, pvt._heightMSL);
+		}
+
+		if (OnRMC && (wantedSentences & SM_RMC)) {
+			const boost::gregorian::date date(validDate ? boost::gregorian::date(pvt._year, pvt._month, pvt._day) : boost::gregorian::date());
+			const double knotsPerMeterPerSecond = 3600.0 / 1852.0;
+			OnRMC(ios, time, pvt._latitude, pvt._longitude, pvt._groundSpeed * knotsPerMeterPerSecond, pvt._heading, date, (gnssFixOK && validTime) ? "A" : "V");
+		}
+		return;
+	}
 
 
-		if (*i == "$GPGSA") {
-			// GSA = GPS DOP and active satellites
-			// $GPGSA,A,3,18,15,21,06,09,,,,,,,,3.7,2.8,2.3*3C
-			i++;  // consume the $GPGSA token
-			std::string mode(*i++);
-			int fix = lexical_cast_default<int>(*i++, 1);  // 1=fix not available
-			std::vector<int> satellitesInView;
-			while (i<v.begin()+15) {
-				int sv = lexical_cast_default<int>(*i++, -1);
-				if (sv != -1)
-					satellitesInView.push_back(sv);
-			}
-			double pdop = lexical_cast_default<double>(*i++, 0);
-			double hdop = lexical_cast_default<double>(*i++, 0);
-			double vdop = lexical_cast_default<double>(*i++, 0);
-
-			if (OnGSA)
-				OnGSA(ios, mode, fix, satellitesInView, pdop, hdop, vdop);
+	if (messageId == UBX_NAV_SAT) {
+		std::vector<UBXSatellite> satellites;
+		if (!DecodeNavSat(payload, payloadLength, satellites))
 			return;
-		}
 
-		// didn't parse anything
-		if (OnInvalidSentence) 
-			OnInvalidSentence(ios, s);
+		std::vector<SatelliteInfo> satelliteInfo;
+		std::vector<int> satellitesUsed;
+		for (std::vector<UBXSatellite>::const_iterator i = satellites.begin(); i != satellites.end(); ++i) {
+			const int prn = NMEASatelliteNumber(i->_gnssId, i->_svId);
+			if (prn == 0)
+				continue;
+			satelliteInfo.push_back(SatelliteInfo(prn, i->_elevation, i->_azimuth, i->_cno));
+			if (i->_used)
+				satellitesUsed.push_back(prn);
+		}
 
-	} catch (const std::exception &e) {
-		std::cout << "Error while decoding >" << s << "< : " << e.what() << std::endl;
-		throw;
+		if (OnGSV && (wantedSentences & SM_GSV))
+			OnGSV(ios, 1, 1, satelliteInfo.size(), satelliteInfo);
+		if (OnGSA && (wantedSentences & SM_GSA)) {
+			const int fix = ((_ubxFixType == 2) || (_ubxFixType == 3)) ? _ubxFixType : ((_ubxFixType == 4) ? 3 : 1);  // 1=fix not available
+			OnGSA(ios, "A", fix, satellitesUsed, _ubxDOP._pdop, _ubxDOP._hdop, _ubxDOP._vdop);
+		}
+		return;
 	}
 }
@@ -8,6 +8,9 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
+#include "SentenceView.h"
+#include "SentenceFramer.h"
+#include "UBX.h"
 #include "GPSLib_Export.h"
 
 namespace GPSLib {
@@ -19,19 +22,57 @@ namespace GPSLib {
 	};
 
 	class GPSLib_Export GPSSentenceDecoder : public boost::enable_shared_from_this<GPSSentenceDecoder> {
-		std::string _buffer;
+		const unsigned int _sentenceMask;
+		const bool _decodeInline;
+		SentenceFramer _framer;
+		UBXFramer _ubxFramer;
+		UBXNavDOP _ubxDOP;  // most recent NAV-DOP, for the GGA and GSA made from NAV-PVT and NAV-SAT
+		int _ubxFixType;  // from the most recent NAV-PVT
+		boost::int64_t _dayStart;  // UTC milliseconds since 1970 at the start of the date of the most recent RMC or NAV-PVT, -1 before one
+		int _dayStartTimeOfDay;  // milliseconds since midnight of the sentence that set _dayStart
 		boost::mutex _bufferMutex;
 		boost::shared_ptr<boost::asio::strand> _decodeStrand;
+		unsigned long _rejected[RR_COUNT];
+		mutable boost::mutex _rejectedMutex;
 		
+		void SetDate(int daysSinceEpoch, int millisecondsOfDay);
+		void Reject(RejectReason reason);
+		void Reject(boost::asio::io_service &ios, RejectReason reason, const std::string &s);
+		unsigned int GetWantedSentences() const;
+		unsigned int GetInstalledHandlers() const;
 		void Decode(boost::asio::io_service &ios, const std::string &s);
+		void DecodeUBX(boost::asio::io_service &ios, const std::vector<unsigned char> &frame);
 	public:
+		// sentences not in sentenceMask are dropped as soon as their address is seen, without checksum or decode
+		// decodeInline decodes each sentence inside AddBytes, on the caller's thread, instead of posting it through a strand -
+		// only for callers that already serialize AddBytes, such as a single read chain on a serial port
+		explicit GPSSentenceDecoder(unsigned int sentenceMask = SM_ALL, bool decodeInline = false);
 		void AddBytes(boost::asio::io_service &ios, const std::vector<unsigned char> &buffer, size_t bufferSize = -1); 
+
+		// UTC milliseconds since 1970 of a time of day, on the date of the most recent RMC (or NAV-PVT) - false if no date has been
+		// seen yet.  A time half a day or more from the one the date came with is taken to be across midnight from it, so a
+		// sentence ahead of the first RMC of a day gets that day.  Only for use in this decoder's callbacks, which run in
+		// arrival order, so the date is the one in effect for the sentence being handled.
+		bool GetUTCMilliseconds(int millisecondsOfDay, boost::int64_t &value) const;
+		bool GetUTCMilliseconds(const SentenceView &view, size_t timeField, boost::int64_t &value) const;
+
+		// sentences and UBX frames rejected so far, for a reason - a malformed stream is counted, not thrown or logged
+		unsigned long GetRejected(RejectReason reason) const;
+
+		// a complete line that was rejected - sentences dropped before their CR-LF are only counted
 		boost::function<void (boost::asio::io_service &, const std::string &)> OnInvalidSentence;
+		// every valid sentence, as a view whose fields are only converted when asked for - called ahead of the On* handlers below
+		boost::function<void (boost::asio::io_service &, const SentenceView &)> OnSentence;
 		boost::function<void (boost::asio::io_service &, boost::posix_time::time_duration, double, double, int, int, double, double)> OnGGA;
 		boost::function<void (boost::asio::io_service &, boost::posix_time::time_duration, double, double, const std::string &)> OnGLL;
 		boost::function<void (boost::asio::io_service &, boost::posix_time::time_duration, double, double, double, double, boost::gregorian::date, const std::string &)> OnRMC;
 		boost::function<void (boost::asio::io_service &, int, int, int, const std::vector<SatelliteInfo> &)> OnGSV;
 		boost::function<void (boost::asio::io_service &, const std::string &, int, const std::vector<int> &, double, double, double)> OnGSA;
+
+		// UBX frames in the same stream are decoded to the handlers above - NAV-PVT to OnGGA and OnRMC, NAV-SAT to OnGSV
+		// (as one message for all satellites) and OnGSA, with NAV-DOP supplying their dilutions.  OnUBX gets every
+		// valid frame, sync chars through checksum, including ones of classes that aren't decoded.
+		boost::function<void (boost::asio::io_service &, const std::vector<unsigned char> &)> OnUBX;
 	};
 }
 #endif
@@ -0,0 +1,47 @@
+#include "GSVAggregator.h"
+
+GPSLib::GSVAggregator::GSVAggregator() :
+_totalMessages(0), _nextMessage(0), _totalSatellitesInView(0), _completeSequences(0), _discardedSequences(0) {
+	_satellites.reserve(MaxSatellites);
+}
+
+void GPSLib::GSVAggregator::Discard() {
+	if (_nextMessage != 0)
+		_discardedSequences++;
+	_nextMessage = 0;
+	_satellites.clear();  // keeps the capacity
+}
+
+void GPSLib::GSVAggregator::Add(boost::asio::io_service &ios, int totalMessages, int messageNumber, int totalSatellitesInView,
+	const std::vector<SatelliteInfo> &satelliteInfo) {
+	if ((totalMessages < 1) || (messageNumber < 1) || (messageNumber > totalMessages)) {
+		Discard();
+		return;
+	}
+
+	if (messageNumber == 1) {
+		Discard();  // a sequence still in progress never completed
+		_totalMessages = totalMessages;
+		_totalSatellitesInView = totalSatellitesInView;
+		_nextMessage = 1;
+	} else if ((messageNumber != _nextMessage) || (totalMessages != _totalMessages) || (totalSatellitesInView != _totalSatellitesInView)) {
+		// a fragment was lost, or this fragment belongs to another sequence
+		Discard();
+		return;
+	}
+
+	for (std::vector<SatelliteInfo>::const_iterator i = satelliteInfo.begin(); i != satelliteInfo.end(); ++i)
+		if ((i->_prn > 0) && (_satellites.size() < MaxSatellites))  // a PRN of 0 is an empty slot in the last fragment
+			_satellites.push_back(*i);
+
+	if (messageNumber < _totalMessages) {
+		_nextMessage++;
+		return;
+	}
+
+	_completeSequences++;
+	if (OnSatellitesInView)
+		OnSatellitesInView(ios, _totalSatellitesInView, _satellites);
+	_nextMessage = 0;
+	_satellites.clear();
+}
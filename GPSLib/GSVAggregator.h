@@ -0,0 +1,34 @@
+#ifndef __GSVAGGREGATOR_H__
+#define __GSVAGGREGATOR_H__
+
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/function.hpp>
+#include "GPSSentenceDecoder.h"
+#include "GPSLib_Export.h"
+
+namespace GPSLib {
+	// Assembles the fragments of a GSV sequence (message 1 of n through n of n) into one table of the satellites
+	// in view, and passes the table on once per complete sequence.  Incomplete and out of order sequences are
+	// discarded.  Add() takes the same arguments as GPSSentenceDecoder::OnGSV, and, like the decoder's handlers,
+	// must not be called concurrently.
+	class GPSLib_Export GSVAggregator {
+	public:
+		enum { MaxSatellites = 64 };
+	private:
+		std::vector<SatelliteInfo> _satellites;  // reserved to MaxSatellites once, then reused for every sequence
+		int _totalMessages, _nextMessage, _totalSatellitesInView;  // _nextMessage is 0 when no sequence is in progress
+		unsigned long _completeSequences, _discardedSequences;
+
+		void Discard();
+	public:
+		GSVAggregator();
+		void Add(boost::asio::io_service &ios, int totalMessages, int messageNumber, int totalSatellitesInView, const std::vector<SatelliteInfo> &satelliteInfo);
+		unsigned long GetCompleteSequences() const { return _completeSequences; }
+		unsigned long GetDiscardedSequences() const { return _discardedSequences; }
+
+		// totalSatellitesInView as reported by the receiver, and the table of satellites - only valid during the call
+		boost::function<void (boost::asio::io_service &, int, const std::vector<SatelliteInfo> &)> OnSatellitesInView;
+	};
+}
+#endif
@@ -0,0 +1,153 @@
+#include "Geodesy.h"
+#include <limits>
+
+namespace {
+	const int MaxVincentyIterations = 200;
+	const double VincentyTolerance = 1e-12;  // radians of longitude on the auxiliary sphere, about 0.006mm
+}
+
+bool GPSLib::VincentyInverse(double lat1, double lon1, double lat2, double lon2, double &distance, double &bearing) {
+	const double f = WGS84::Flattening, a = WGS84::SemiMajorAxis, b = WGS84::SemiMinorAxis;
+	const double L = (lon2 - lon1) * DegreesToRadians;
+	// reduced latitudes
+	const double tanU1 = (1.0 - f) * std::tan(lat1 * DegreesToRadians), cosU1 = 1.0 / std::sqrt(1.0 + tanU1 * tanU1), sinU1 = tanU1 * cosU1;
+	const double tanU2 = (1.0 - f) * std::tan(lat2 * DegreesToRadians), cosU2 = 1.0 / std::sqrt(1.0 + tanU2 * tanU2), sinU2 = tanU2 * cosU2;
+
+	double lambda = L, sinLambda, cosLambda, sinSigma, cosSigma, sigma, cosSquaredAlpha, cos2SigmaM;
+	for (int i = 0; ; i++) {
+		if (i == MaxVincentyIterations)
+			return false;
+		sinLambda = std::sin(lambda);
+		cosLambda = std::cos(lambda);
+		const double t = cosU1 * sinU2 - sinU1 * cosU2 * cosLambda;
+		sinSigma = std::sqrt((cosU2 * sinLambda) * (cosU2 * sinLambda) + t * t);
+		if (sinSigma == 0) {  // the same point
+			distance = bearing = 0;
+			return true;
+		}
+		cosSigma = sinU1 * sinU2 + cosU1 * cosU2 * cosLambda;
+		sigma = std::atan2(sinSigma, cosSigma);
+		const double sinAlpha = cosU1 * cosU2 * sinLambda / sinSigma;
+		cosSquaredAlpha = 1.0 - sinAlpha * sinAlpha;
+		cos2SigmaM = (cosSquaredAlpha != 0) ? cosSigma - 2.0 * sinU1 * sinU2 / cosSquaredAlpha : 0;  // 0 on the equator
+		const double C = f / 16.0 * cosSquaredAlpha * (4.0 + f * (4.0 - 3.0 * cosSquaredAlpha));
+		const double lastLambda = lambda;
+		lambda = L + (1.0 - C) * f * sinAlpha * (sigma + C * sinSigma * (cos2SigmaM + C * cosSigma * (-1.0 + 2.0 * cos2SigmaM * cos2SigmaM)));
+		if (std::fabs(lambda - lastLambda) < VincentyTolerance)
+			break;
+	}
+	if (std::fabs(lambda) > Pi)
+		return false;
+
+	const double uSquared = cosSquaredAlpha * (a * a - b * b) / (b * b);
+	const double A = 1.0 + uSquared / 16384.0 * (4096.0 + uSquared * (-768.0 + uSquared * (320.0 - 175.0 * uSquared)));
+	const double B = uSquared / 1024.0 * (256.0 + uSquared * (-128.0 + uSquared * (74.0 - 47.0 * uSquared)));
+	const double deltaSigma = B * sinSigma * (cos2SigmaM + B / 4.0 * (cosSigma * (-1.0 + 2.0 * cos2SigmaM * cos2SigmaM) -
+		B / 6.0 * cos2SigmaM * (-3.0 + 4.0 * sinSigma * sinSigma) * (-3.0 + 4.0 * cos2SigmaM * cos2SigmaM)));
+	distance = b * A * (sigma - deltaSigma);
+	bearing = std::atan2(cosU2 * sinLambda, cosU1 * sinU2 - sinU1 * cosU2 * cosLambda) * RadiansToDegrees;
+	if (bearing < 0)
+		bearing += 360.0;
+	return true;
+}
+
+// The kernels below that call sin, cos and friends only vectorize where the compiler has vector versions of them,
+// such as with a vector math library - elsewhere they gain from work hoisted out of the loop, not from SIMD.
+
+void GPSLib::NMEAToDecimalDegrees(const double *ddmm, const char *hemispheres, double *decimalDegrees, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		const double degrees = static_cast<int>(ddmm[i] / 100.0);
+		const double value = degrees + (ddmm[i] - degrees * 100.0) / 60.0;
+		const double sign = 1.0 - 2.0 * ((hemispheres[i] == 'S') | (hemispheres[i] == 'W'));
+		decimalDegrees[i] = sign * value;
+	}
+}
+
+void GPSLib::ToDegreesMinutesSeconds(const double *decimalDegrees, int *degrees, int *minutes, int *seconds, size_t count) {
+	// truncating conversions in place of modf - the same integer and fractional parts, exactly
+	for (size_t i = 0; i < count; i++) {
+		const int d = static_cast<int>(decimalDegrees[i]);
+		const double m = (decimalDegrees[i] - d) * 60.0;
+		const int intMinutes = static_cast<int>(m);
+		degrees[i] = d;
+		minutes[i] = intMinutes;
+		seconds[i] = static_cast<int>((m - intMinutes) * 60.0);
+	}
+}
+
+void GPSLib::HaversineDistances(const double *lat1, const double *lon1, const double *lat2, const double *lon2, double *distances, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		const double sinHalfDLat = std::sin((lat2[i] - lat1[i]) * DegreesToRadians / 2.0);
+		const double sinHalfDLon = std::sin((lon2[i] - lon1[i]) * DegreesToRadians / 2.0);
+		const double a = sinHalfDLat * sinHalfDLat +
+			std::cos(lat1[i] * DegreesToRadians) * std::cos(lat2[i] * DegreesToRadians) * sinHalfDLon * sinHalfDLon;
+		distances[i] = 2.0 * EarthMeanRadius * std::asin(std::sqrt(a));
+	}
+}
+
+void GPSLib::InitialBearings(const double *lat1, const double *lon1, const double *lat2, const double *lon2, double *bearings, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		const double phi1 = lat1[i] * DegreesToRadians, phi2 = lat2[i] * DegreesToRadians;
+		const double dLon = (lon2[i] - lon1[i]) * DegreesToRadians;
+		const double cosPhi2 = std::cos(phi2);
+		bearings[i] = std::atan2(std::sin(dLon) * cosPhi2,
+			std::cos(phi1) * std::sin(phi2) - std::sin(phi1) * cosPhi2 * std::cos(dLon)) * RadiansToDegrees;
+	}
+	// in its own pass, so the one above has no branch
+	for (size_t i = 0; i < count; i++)
+		bearings[i] += (bearings[i] < 0) ? 360.0 : 0.0;
+}
+
+void GPSLib::TrackDistances(const double *lat, const double *lon, double *distances, size_t count) {
+	if (count < 2)
+		return;
+	// each point's cosine of latitude serves the legs on both sides of it
+	double cosLat = std::cos(lat[0] * DegreesToRadians);
+	for (size_t i = 0; i + 1 < count; i++) {
+		const double nextCosLat = std::cos(lat[i+1] * DegreesToRadians);
+		const double sinHalfDLat = std::sin((lat[i+1] - lat[i]) * DegreesToRadians / 2.0);
+		const double sinHalfDLon = std::sin((lon[i+1] - lon[i]) * DegreesToRadians / 2.0);
+		const double a = sinHalfDLat * sinHalfDLat + cosLat * nextCosLat * sinHalfDLon * sinHalfDLon;
+		distances[i] = 2.0 * EarthMeanRadius * std::asin(std::sqrt(a));
+		cosLat = nextCosLat;
+	}
+}
+
+size_t GPSLib::VincentyInverse(const double *lat1, const double *lon1, const double *lat2, const double *lon2,
+	double *distances, double *bearings, size_t count) {
+	// iterative, with a different number of iterations for each pair, so there is no vector form
+	size_t failed = 0;
+	for (size_t i = 0; i < count; i++)
+		if (!VincentyInverse(lat1[i], lon1[i], lat2[i], lon2[i], distances[i], bearings[i])) {
+			distances[i] = bearings[i] = std::numeric_limits<double>::quiet_NaN();
+			failed++;
+		}
+	return failed;
+}
+
+void GPSLib::GeodeticToECEF(const double *lat, const double *lon, const double *height, double *x, double *y, double *z, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		const double sinLat = std::sin(lat[i] * DegreesToRadians), cosLat = std::cos(lat[i] * DegreesToRadians);
+		const double primeVerticalRadius = WGS84::SemiMajorAxis / std::sqrt(1.0 - WGS84::EccentricitySquared * sinLat * sinLat);
+		x[i] = (primeVerticalRadius + height[i]) * cosLat * std::cos(lon[i] * DegreesToRadians);
+		y[i] = (primeVerticalRadius + height[i]) * cosLat * std::sin(lon[i] * DegreesToRadians);
+		z[i] = (primeVerticalRadius * (1.0 - WGS84::EccentricitySquared) + height[i]) * sinLat;
+	}
+}
+
+void GPSLib::GeodeticToENU(const double *lat, const double *lon, const double *height, double refLat, double refLon, double refHeight,
+	double *east, double *north, double *up, size_t count) {
+	// ECEF into the output arrays, then rotate them in place - the rotation is plain arithmetic, and vectorizes
+	GeodeticToECEF(lat, lon, height, east, north, up, count);
+
+	double refX, refY, refZ;
+	GPSLib::GeodeticToECEF(refLat, refLon, refHeight, refX, refY, refZ);
+	const double sinLat = std::sin(refLat * DegreesToRadians), cosLat = std::cos(refLat * DegreesToRadians);
+	const double sinLon = std::sin(refLon * DegreesToRadians), cosLon = std::cos(refLon * DegreesToRadians);
+	for (size_t i = 0; i < count; i++) {
+		const double dx = east[i] - refX, dy = north[i] - refY, dz = up[i] - refZ;
+		east[i] = -sinLon * dx + cosLon * dy;
+		north[i] = -sinLat * cosLon * dx - sinLat * sinLon * dy + cosLat * dz;
+		up[i] = cosLat * cosLon * dx + cosLat * sinLon * dy + sinLat * dz;
+	}
+}
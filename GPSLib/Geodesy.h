@@ -0,0 +1,107 @@
+#ifndef __GEODESY_H__
+#define __GEODESY_H__
+
+#include <cmath>
+#include <cstddef>
+#include "GPSLib_Export.h"
+
+namespace GPSLib {
+	// WGS-84 ellipsoid, and the mean radius used for great circle distances
+	namespace WGS84 {
+		const double SemiMajorAxis = 6378137.0;  // meters
+		const double Flattening = 1.0 / 298.257223563;
+		const double SemiMinorAxis = SemiMajorAxis * (1.0 - Flattening);
+		const double EccentricitySquared = Flattening * (2.0 - Flattening);
+	}
+	const double EarthMeanRadius = 6371008.8;  // meters
+	const double Pi = 3.14159265358979323846;
+	const double DegreesToRadians = Pi / 180.0;
+	const double RadiansToDegrees = 180.0 / Pi;
+
+	// Scalar conversions, one coordinate at a time.  These are the reference the batch kernels below are tested and
+	// benchmarked against.  Angles are decimal degrees, distances and heights meters.
+
+	// an NMEA ddmm.mmmm (or dddmm.mmmm) value and its N/S/E/W hemisphere
+	inline double NMEAToDecimalDegree(double ddmm, char hemisphere) {
+		const double degrees = static_cast<int>(ddmm / 100.0);
+		const double decimalDegrees = degrees + (ddmm - degrees * 100.0) / 60.0;
+		return ((hemisphere == 'S') || (hemisphere == 'W')) ? -decimalDegrees : decimalDegrees;
+	}
+
+	// great circle distance on a sphere of EarthMeanRadius - within about 0.5% of the ellipsoidal distance
+	// http://www.movable-type.co.uk/scripts/latlong.html
+	inline double HaversineDistance(double lat1, double lon1, double lat2, double lon2) {
+		const double sinHalfDLat = std::sin((lat2 - lat1) * DegreesToRadians / 2.0);
+		const double sinHalfDLon = std::sin((lon2 - lon1) * DegreesToRadians / 2.0);
+		const double a = sinHalfDLat * sinHalfDLat +
+			std::cos(lat1 * DegreesToRadians) * std::cos(lat2 * DegreesToRadians) * sinHalfDLon * sinHalfDLon;
+		return 2.0 * EarthMeanRadius * std::asin(std::sqrt(a));
+	}
+
+	// great circle bearing leaving the first point, [0, 360) degrees true
+	inline double InitialBearing(double lat1, double lon1, double lat2, double lon2) {
+		const double phi1 = lat1 * DegreesToRadians, phi2 = lat2 * DegreesToRadians;
+		const double dLon = (lon2 - lon1) * DegreesToRadians;
+		const double bearing = std::atan2(std::sin(dLon) * std::cos(phi2),
+			std::cos(phi1) * std::sin(phi2) - std::sin(phi1) * std::cos(phi2) * std::cos(dLon)) * RadiansToDegrees;
+		return (bearing < 0) ? bearing + 360.0 : bearing;
+	}
+
+	// the smaller angle between two bearings or courses, [0, 180] degrees - so 359 and 1 are 2 apart
+	inline double AngleBetween(double bearing1, double bearing2) {
+		const double difference = std::fmod(std::fabs(bearing1 - bearing2), 360.0);
+		return (difference > 180.0) ? 360.0 - difference : difference;
+	}
+
+	// distance and initial bearing on the WGS-84 ellipsoid, to within a millimeter - false if the iteration doesn't
+	// converge, as it may not for nearly antipodal points
+	// http://www.movable-type.co.uk/scripts/latlong-vincenty.html
+	GPSLib_Export bool VincentyInverse(double lat1, double lon1, double lat2, double lon2, double &distance, double &bearing);
+
+	// Earth-centered, Earth-fixed
+	inline void GeodeticToECEF(double lat, double lon, double height, double &x, double &y, double &z) {
+		const double sinLat = std::sin(lat * DegreesToRadians), cosLat = std::cos(lat * DegreesToRadians);
+		const double primeVerticalRadius = WGS84::SemiMajorAxis / std::sqrt(1.0 - WGS84::EccentricitySquared * sinLat * sinLat);
+		x = (primeVerticalRadius + height) * cosLat * std::cos(lon * DegreesToRadians);
+		y = (primeVerticalRadius + height) * cosLat * std::sin(lon * DegreesToRadians);
+		z = (primeVerticalRadius * (1.0 - WGS84::EccentricitySquared) + height) * sinLat;
+	}
+
+	// east, north, up from a reference point
+	inline void GeodeticToENU(double lat, double lon, double height, double refLat, double refLon, double refHeight,
+		double &east, double &north, double &up) {
+		double x, y, z, refX, refY, refZ;
+		GeodeticToECEF(lat, lon, height, x, y, z);
+		GeodeticToECEF(refLat, refLon, refHeight, refX, refY, refZ);
+		const double dx = x - refX, dy = y - refY, dz = z - refZ;
+		const double sinLat = std::sin(refLat * DegreesToRadians), cosLat = std::cos(refLat * DegreesToRadians);
+		const double sinLon = std::sin(refLon * DegreesToRadians), cosLon = std::cos(refLon * DegreesToRadians);
+		east = -sinLon * dx + cosLon * dy;
+		north = -sinLat * cosLon * dx - sinLat * sinLon * dy + cosLat * dz;
+		up = cosLat * cosLon * dx + cosLat * sinLon * dy + sinLat * dz;
+	}
+
+	// Batch kernels over contiguous arrays of count elements, for track analytics over a window of fixes.  Each gives
+	// the same results as calling its scalar counterpart in a loop.  The loops are written without branches or calls
+	// that can't be inlined where the arithmetic allows it, so the compiler can vectorize them, and anything that only
+	// depends on a reference point, or is shared between neighbouring points of a track, is computed once.  Output
+	// arrays may not overlap the inputs.
+
+	GPSLib_Export void NMEAToDecimalDegrees(const double *ddmm, const char *hemispheres, double *decimalDegrees, size_t count);
+	// as ToDegreesMinutesSeconds in Util.h
+	GPSLib_Export void ToDegreesMinutesSeconds(const double *decimalDegrees, int *degrees, int *minutes, int *seconds, size_t count);
+
+	// between point i of the first arrays and point i of the second
+	GPSLib_Export void HaversineDistances(const double *lat1, const double *lon1, const double *lat2, const double *lon2, double *distances, size_t count);
+	GPSLib_Export void InitialBearings(const double *lat1, const double *lon1, const double *lat2, const double *lon2, double *bearings, size_t count);
+	// legs of a track of count points - distances[i] is from point i to point i+1, so count-1 of them
+	GPSLib_Export void TrackDistances(const double *lat, const double *lon, double *distances, size_t count);
+	// the number of pairs that didn't converge, for which distance and bearing are NaN
+	GPSLib_Export size_t VincentyInverse(const double *lat1, const double *lon1, const double *lat2, const double *lon2,
+		double *distances, double *bearings, size_t count);
+
+	GPSLib_Export void GeodeticToECEF(const double *lat, const double *lon, const double *height, double *x, double *y, double *z, size_t count);
+	GPSLib_Export void GeodeticToENU(const double *lat, const double *lon, const double *height, double refLat, double refLon, double refHeight,
+		double *east, double *north, double *up, size_t count);
+}
+#endif
@@ -0,0 +1,148 @@
+#include "LatestStateTable.h"
+#include <new>
+#include <boost/functional/hash.hpp>
+
+const size_t GPSLib::LatestStateTable::npos;
+
+namespace {
+	size_t RoundUpToPowerOfTwo(size_t n) {
+		size_t p = 2;  // at least one slot claimed and one left free, for Find to stop at
+		while (p < n)
+			p <<= 1;
+		return p;
+	}
+}
+
+GPSLib::LatestStateTable::LatestStateTable(size_t capacity) : _capacity(RoundUpToPowerOfTwo(capacity)),
+	_storage(RoundUpToPowerOfTwo(capacity) * SlotSize + CacheLine), _refused(0) {
+	const size_t misalignment = reinterpret_cast<size_t>(&_storage[0]) % CacheLine;
+	_slots = &_storage[0] + (misalignment ? CacheLine - misalignment : 0);
+	for (size_t i = 0; i < _capacity; i++) {
+		Slot &slot = *new (_slots + i * SlotSize) Slot;
+		slot._sequence = 0;
+		slot._sensorID = 0;
+		slot._state._positionDate = slot._state._altitudeDate = slot._state._courseDate = 0;
+		slot._state._latitude = slot._state._longitude = slot._state._altitude = slot._state._speed = slot._state._course = 0;
+	}
+}
+
+size_t GPSLib::LatestStateTable::Claim(const std::string &sensorID) {
+	const size_t found = Find(sensorID);
+	if (found != npos)
+		return found;
+
+	if (_sensorIDs.size() >= _capacity * 3 / 4) {
+		_refused++;
+		return npos;
+	}
+
+	// linear probing from the ID's hash, to the first free slot - Find stops there too
+	size_t handle = boost::hash<std::string>()(sensorID) & (_capacity - 1);
+	while (GetSlot(handle)._sensorID != 0)
+		handle = (handle + 1) & (_capacity - 1);
+
+	_sensorIDs.push_back(sensorID);
+	MemoryFence();  // the interned ID is complete before the slot is seen to be claimed
+	GetSlot(handle)._sensorID = &_sensorIDs.back();
+	return handle;
+}
+
+void GPSLib::LatestStateTable::BeginWrite(Slot &slot) {
+	slot._sequence = slot._sequence + 1;  // odd - only ever written with the writer lock
+	MemoryFence();
+}
+
+void GPSLib::LatestStateTable::EndWrite(Slot &slot) {
+	MemoryFence();
+	slot._sequence = slot._sequence + 1;
+}
+
+bool GPSLib::LatestStateTable::UpdatePosition(const std::string &sensorID, boost::uint64_t date, double latitude, double longitude) {
+	boost::mutex::scoped_lock lock(_writerMutex);
+	const size_t handle = Claim(sensorID);
+	if (handle == npos)
+		return false;
+
+	Slot &slot = GetSlot(handle);
+	if (date < slot._state._positionDate)
+		return true;  // older than the state already held - the writer lock keeps the date from changing meanwhile
+	BeginWrite(slot);
+	slot._state._positionDate = date;
+	slot._state._latitude = latitude;
+	slot._state._longitude = longitude;
+	EndWrite(slot);
+	return true;
+}
+
+bool GPSLib::LatestStateTable::UpdateAltitude(const std::string &sensorID, boost::uint64_t date, double altitude) {
+	boost::mutex::scoped_lock lock(_writerMutex);
+	const size_t handle = Claim(sensorID);
+	if (handle == npos)
+		return false;
+
+	Slot &slot = GetSlot(handle);
+	if (date < slot._state._altitudeDate)
+		return true;  // older than the state already held - the writer lock keeps the date from changing meanwhile
+	BeginWrite(slot);
+	slot._state._altitudeDate = date;
+	slot._state._altitude = altitude;
+	EndWrite(slot);
+	return true;
+}
+
+bool GPSLib::LatestStateTable::UpdateCourse(const std::string &sensorID, boost::uint64_t date, double speed, double course) {
+	boost::mutex::scoped_lock lock(_writerMutex);
+	const size_t handle = Claim(sensorID);
+	if (handle == npos)
+		return false;
+
+	Slot &slot = GetSlot(handle);
+	if (date < slot._state._courseDate)
+		return true;  // older than the state already held - the writer lock keeps the date from changing meanwhile
+	BeginWrite(slot);
+	slot._state._courseDate = date;
+	slot._state._speed = speed;
+	slot._state._course = course;
+	EndWrite(slot);
+	return true;
+}
+
+size_t GPSLib::LatestStateTable::Find(const std::string &sensorID) const {
+	size_t handle = boost::hash<std::string>()(sensorID) & (_capacity - 1);
+	while (true) {
+		const std::string *const claimed = GetSlot(handle)._sensorID;
+		if (claimed == 0)
+			return npos;  // slots are never freed, so the ID would have been found by here
+		MemoryFence();
+		if (*claimed == sensorID)
+			return handle;
+		handle = (handle + 1) & (_capacity - 1);
+	}
+}
+
+void GPSLib::LatestStateTable::Get(size_t handle, SensorState &state) const {
+	const Slot &slot = GetSlot(handle);
+	while (true) {
+		const long before = slot._sequence;
+		if (before & 1)
+			continue;  // being written, which takes only a few stores
+		MemoryFence();
+		state = slot._state;
+		MemoryFence();
+		if (slot._sequence == before)
+			return;
+	}
+}
+
+bool GPSLib::LatestStateTable::Get(const std::string &sensorID, SensorState &state) const {
+	const size_t handle = Find(sensorID);
+	if (handle == npos)
+		return false;
+	Get(handle, state);
+	return true;
+}
+
+size_t GPSLib::LatestStateTable::GetSize() const {
+	boost::mutex::scoped_lock lock(_writerMutex);
+	return _sensorIDs.size();
+}
@@ -0,0 +1,92 @@
+#ifndef __LATESTSTATETABLE_H__
+#define __LATESTSTATETABLE_H__
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include "GPSLib_Export.h"
+
+namespace GPSLib {
+	// A full memory barrier for the table's seqlocks - there is no std::atomic on every compiler this builds with.  On
+	// x86 and x64 stores stay in order with stores and loads with loads, so only the compiler need be kept from
+	// reordering, but ARM reorders both, so takes a data memory barrier.
+	inline void MemoryFence() {
+#if defined(_MSC_VER) && defined(_M_ARM64)
+		__dmb(_ARM64_BARRIER_ISH);
+#elif defined(_MSC_VER) && defined(_M_ARM)
+		__dmb(_ARM_BARRIER_ISH);
+#elif defined(_MSC_VER)
+		_ReadWriteBarrier();
+#else
+		__sync_synchronize();
+#endif
+	}
+
+	// the latest of each part of a sensor's state, merged from the topics that carry them - dates are UTC milliseconds,
+	// as in the GPS topics, and 0 for a part not yet seen
+	class SensorState {
+	public:
+		boost::uint64_t _positionDate, _altitudeDate, _courseDate;
+		double _latitude, _longitude;
+		double _altitude;  // meters
+		double _speed, _course;  // knots, degrees true
+	};
+
+	// The latest state of each sensor, for many reader threads at once without a lock between them, or with the writer.
+	// Each sensor has a slot of its own in an open addressed table, a cache line or two to itself so readers of one
+	// don't slow writes to another, and guarded by a seqlock - a writer makes the slot's sequence odd, updates it, and
+	// makes it even again, and a reader copies the slot out and retries if the sequence was odd or changed meanwhile.
+	// Sensor IDs are interned as slots are claimed, never removed, so a slot's handle from Find stays valid, and
+	// saves hashing on later lookups.  Writers take a lock among themselves, so may be on any threads.  The table is
+	// refused new sensors once capacity is three quarters full.
+	class GPSLib_Export LatestStateTable : private boost::noncopyable {
+		enum { CacheLine = 64 };
+		class Slot {
+		public:
+			volatile long _sequence;
+			const std::string *volatile _sensorID;  // 0 until claimed, then never changed
+			SensorState _state;
+		};
+		enum { SlotSize = ((sizeof(Slot) + CacheLine - 1) / CacheLine) * CacheLine };
+
+		const size_t _capacity;  // a power of two
+		std::vector<char> _storage;
+		char *_slots;  // _storage, from its first cache line boundary
+		mutable boost::mutex _writerMutex;
+		std::deque<std::string> _sensorIDs;  // interned, in the order claimed - a deque, so each stays where it is
+		unsigned long _refused;
+
+		Slot &GetSlot(size_t handle) const { return *reinterpret_cast<Slot *>(_slots + handle * SlotSize); }
+		size_t Claim(const std::string &sensorID);  // with the writer lock held - npos if full
+		void BeginWrite(Slot &slot);
+		void EndWrite(Slot &slot);
+	public:
+		static const size_t npos = static_cast<size_t>(-1);
+
+		explicit LatestStateTable(size_t capacity = 4096);  // rounded up to a power of two, of at least 2
+		// the capacity that holds this many sensors before refusing any
+		static size_t CapacityFor(size_t sensors) { return sensors * 4 / 3 + 1; }
+
+		// false if the sensor is new and the table full - an update dated before the part's latest is ignored, as the
+		// topics carrying the parts may be read on different threads, and arrive out of order
+		bool UpdatePosition(const std::string &sensorID, boost::uint64_t date, double latitude, double longitude);
+		bool UpdateAltitude(const std::string &sensorID, boost::uint64_t date, double altitude);
+		bool UpdateCourse(const std::string &sensorID, boost::uint64_t date, double speed, double course);
+
+		// the sensor's handle, or npos if it has never been updated - lock free
+		size_t Find(const std::string &sensorID) const;
+		// a consistent copy of the sensor's state - lock free
+		void Get(size_t handle, SensorState &state) const;
+		bool Get(const std::string &sensorID, SensorState &state) const;
+
+		size_t GetSize() const;  // sensors, with the writer lock
+		unsigned long GetRefused() const { return _refused; }
+	};
+}
+#endif
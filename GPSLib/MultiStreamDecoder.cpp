@@ -0,0 +1,71 @@
+#include "MultiStreamDecoder.h"
+#include <boost/bind.hpp>
+
+GPSLib::MultiStreamDecoder::MultiStreamDecoder(boost::asio::io_service &ios, unsigned int numShards, unsigned int sentenceMask) :
+_sentenceMask(sentenceMask) {
+	for (unsigned int i = 0; i < std::max(numShards, 1U); ++i)
+		_shards.push_back(boost::shared_ptr<Shard>(new Shard(ios)));
+	std::fill(_rejected, _rejected + RR_COUNT, 0);
+}
+
+GPSLib::MultiStreamDecoder::Shard &GPSLib::MultiStreamDecoder::GetShard(unsigned int streamId) const {
+	// ids are often sequential, so mix them (Knuth's multiplicative hash) before picking a shard - the mixing is in
+	// the high bits of the product, so they pick it, scaled to the shard count, rather than the low bits a % would
+	const boost::uint32_t hash = static_cast<boost::uint32_t>(streamId * 2654435761U);
+	return *_shards[static_cast<size_t>((static_cast<boost::uint64_t>(hash) * _shards.size()) >> 32)];
+}
+
+unsigned long GPSLib::MultiStreamDecoder::GetRejected(RejectReason reason) const {
+	boost::mutex::scoped_lock lock(_rejectedMutex);
+	return _rejected[reason];
+}
+
+void GPSLib::MultiStreamDecoder::Reject(RejectReason reason) {
+	// counted from every shard's strand
+	boost::mutex::scoped_lock lock(_rejectedMutex);
+	_rejected[reason]++;
+}
+
+void GPSLib::MultiStreamDecoder::AddBytes(boost::asio::io_service &ios, unsigned int streamId, const std::vector<unsigned char> &buffer, size_t bufferSize) {
+	// pass bufferSize in case buffer has size greater than the amount of meaningful data in it
+	const std::vector<unsigned char>::const_iterator end = (bufferSize == -1) ? buffer.end() : (buffer.begin() + bufferSize);
+	GetShard(streamId)._strand.post(boost::bind(&MultiStreamDecoder::Decode, shared_from_this(), boost::ref(ios), streamId,
+		std::vector<unsigned char>(buffer.begin(), end)));
+}
+
+void GPSLib::MultiStreamDecoder::Decode(boost::asio::io_service &ios, unsigned int streamId, const std::vector<unsigned char> &buffer) {
+	// running in the shard's strand, so the shard is not touched by anything else
+	Shard &shard = GetShard(streamId);
+	boost::unordered_map<unsigned int, size_t>::const_iterator i = shard._streamIndex.find(streamId);
+	if (i == shard._streamIndex.end()) {
+		i = shard._streamIndex.insert(std::make_pair(streamId, shard._streams.size())).first;
+		shard._streams.push_back(Stream(streamId));
+	}
+	SentenceFramer &framer = shard._streams[i->second]._framer;
+
+	for (std::vector<unsigned char>::const_iterator c = buffer.begin(); c != buffer.end(); ++c) {
+		switch (framer.Add(*c, _sentenceMask)) {
+		case SentenceFramer::Complete: {
+			SentenceView view;
+			RejectReason reason;
+			if (view.Parse(framer.GetSentence(), framer.GetSentence() + framer.GetLength(), reason)) {
+				if (OnSentence)
+					OnSentence(ios, streamId, view);
+			} else {
+				Reject(reason);
+				if (OnInvalidSentence)
+					OnInvalidSentence(ios, streamId, std::string(framer.GetSentence(), framer.GetLength()));
+			}
+			break;
+		}
+		case SentenceFramer::TooLong:
+			Reject(RR_TOO_LONG);
+			break;
+		case SentenceFramer::Truncated:
+			Reject(RR_TRUNCATED);
+			break;
+		default:
+			break;
+		}
+	}
+}
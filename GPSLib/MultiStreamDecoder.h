@@ -0,0 +1,59 @@
+#ifndef __MULTISTREAMDECODER_H__
+#define __MULTISTREAMDECODER_H__
+
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include "SentenceFramer.h"
+#include "SentenceView.h"
+#include "GPSLib_Export.h"
+
+namespace GPSLib {
+	// Decodes sentences from many streams (receivers) with one object.  Streams are identified by the caller's id,
+	// and are sharded by id over a fixed number of strands.  Each shard keeps the framing state of its streams in
+	// one contiguous table that only its strand touches, so there is no lock, and a stream is always decoded in
+	// order, on whichever Executor worker is running its shard.  Sentences are handed on as SentenceViews, which
+	// are only valid during the callback.  Like GPSSentenceDecoder, must be managed by a shared_ptr.  There is no
+	// UBX framing and no per-stream date, so GPSPublisher, which needs both, keeps a GPSSentenceDecoder per receiver.
+	class GPSLib_Export MultiStreamDecoder : private boost::noncopyable, public boost::enable_shared_from_this<MultiStreamDecoder> {
+		struct Stream {
+			unsigned int _id;
+			SentenceFramer _framer;
+			Stream(unsigned int id) : _id(id) {}
+		};
+
+		struct Shard {
+			boost::asio::strand _strand;
+			std::vector<Stream> _streams;
+			boost::unordered_map<unsigned int, size_t> _streamIndex;  // stream id to its position in _streams
+			Shard(boost::asio::io_service &ios) : _strand(ios) {}
+		};
+
+		const unsigned int _sentenceMask;
+		std::vector<boost::shared_ptr<Shard>> _shards;
+		unsigned long _rejected[RR_COUNT];
+		mutable boost::mutex _rejectedMutex;
+
+		Shard &GetShard(unsigned int streamId) const;
+		void Reject(RejectReason reason);
+		void Decode(boost::asio::io_service &ios, unsigned int streamId, const std::vector<unsigned char> &buffer);
+	public:
+		// sentences not in sentenceMask are dropped as soon as their address is seen
+		MultiStreamDecoder(boost::asio::io_service &ios, unsigned int numShards, unsigned int sentenceMask = SM_ALL);
+
+		void AddBytes(boost::asio::io_service &ios, unsigned int streamId, const std::vector<unsigned char> &buffer, size_t bufferSize = -1);
+		size_t GetShardCount() const { return _shards.size(); }
+
+		// sentences rejected so far, for a reason, over all streams
+		unsigned long GetRejected(RejectReason reason) const;
+
+		// every valid sentence, including ones of a type that can't be decoded - check SentenceView::GetType()
+		boost::function<void (boost::asio::io_service &, unsigned int, const SentenceView &)> OnSentence;
+		// a complete line that was rejected - sentences dropped before their CR-LF are only counted
+		boost::function<void (boost::asio::io_service &, unsigned int, const std::string &)> OnInvalidSentence;
+	};
+}
+#endif
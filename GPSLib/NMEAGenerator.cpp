@@ -0,0 +1,240 @@
+#include "NMEAGenerator.h"
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+
+namespace {
+	const double Pi = 3.14159265358979323846;
+
+	struct Satellite { int _prn, _elevation, _azimuth, _snr; };
+	// a fixed sky, slowly rotated as time passes
+	const Satellite Sky[] = {
+		{18, 62, 311, 37}, {15, 47, 49, 40}, {14, 16, 218, 30}, {29, 11, 186, 28}, {21, 39, 131, 35},
+		{6, 52, 277, 41}, {9, 24, 83, 33}, {26, 8, 342, 22}, {27, 71, 12, 44}, {22, 5, 160, 0}
+	};
+	const int SkySize = sizeof(Sky) / sizeof(Sky[0]);
+	const int ActiveSatellites = 6;  // the first few in Sky are used in the fix
+	const int SatellitesPerGSV = 4;
+
+	// ddmm.mmmm (dddmm.mmmm for longitude) and hemisphere
+	void AppendLatLng(std::ostream &os, double decimalDegrees, int degreeDigits, char positive, char negative) {
+		const double a = std::fabs(decimalDegrees);
+		int degrees = static_cast<int>(a);
+		double minutes = std::floor((a - degrees) * 60.0 * 10000.0 + 0.5) / 10000.0;
+		if (minutes >= 60.0) {  // rounded up to the next degree
+			degrees++;
+			minutes -= 60.0;
+		}
+		os << std::setfill('0') << std::setw(degreeDigits) << degrees << std::setw(7) << std::fixed << std::setprecision(4) << minutes
+			<< ',' << ((decimalDegrees < 0) ? negative : positive);
+	}
+
+	// hhmmss.sss
+	void AppendTime(std::ostream &os, const boost::posix_time::time_duration &t) {
+		os << std::setfill('0') << std::setw(2) << t.hours() << std::setw(2) << t.minutes() << std::setw(2) << t.seconds()
+			<< '.' << std::setw(3) << (t.total_milliseconds() % 1000);
+	}
+
+	void PutU2(std::vector<unsigned char> &payload, size_t offset, unsigned int value) {
+		payload[offset] = value & 0xFF;
+		payload[offset+1] = (value >> 8) & 0xFF;
+	}
+
+	void PutU4(std::vector<unsigned char> &payload, size_t offset, unsigned int value) {
+		PutU2(payload, offset, value & 0xFFFF);
+		PutU2(payload, offset+2, value >> 16);
+	}
+
+	void AppendUBX(std::string &s, unsigned char messageClass, unsigned char messageId, const std::vector<unsigned char> &payload) {
+		const std::vector<unsigned char> frame(GPSLib::MakeUBXFrame(messageClass, messageId, payload));
+		s.append(frame.begin(), frame.end());
+	}
+
+	// ddmmyy
+	void AppendDate(std::ostream &os, const boost::gregorian::date &d) {
+		os << std::setfill('0') << std::setw(2) << d.day().as_number() << std::setw(2) << d.month().as_number() << std::setw(2) << (d.year() % 100);
+	}
+}
+
+GPSLib::NMEAGenerator::NMEAGenerator(double latitude, double longitude, double speed, double course, const boost::posix_time::ptime &start, unsigned int seed) :
+_random(seed), _time(start), _latitude(latitude), _longitude(longitude), _altitude(132.0), _speed(speed), _course(course), _turnRate(0),
+_rate(1), _sentenceMask(SM_ALL), _talkers(1, "GP"), _corruptRate(0), _partialRate(0), _sentenceCount(0), _talkerIndex(0) {}
+
+double GPSLib::NMEAGenerator::Uniform() {
+	return static_cast<double>(_random() - _random.min()) / (static_cast<double>(_random.max() - _random.min()) + 1.0);
+}
+
+std::string GPSLib::NMEAGenerator::MakeSentence(const std::string &body) {
+	unsigned char checksum = 0;
+	for (std::string::const_iterator i = body.begin(); i != body.end(); ++i)
+		checksum ^= *i;
+	std::ostringstream os;
+	os << '$' << body << '*' << std::uppercase << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(checksum) << "\r\n";
+	return os.str();
+}
+
+void GPSLib::NMEAGenerator::Append(std::string &s, const std::string &body) {
+	const std::string &talker = _talkers[_talkerIndex++ % _talkers.size()];
+	std::string sentence(MakeSentence(talker + body));
+	_sentenceCount++;
+
+	if ((_corruptRate > 0) && (Uniform() < _corruptRate)) {
+		// change one character of the address or fields - the checksum covers them all, so it no longer matches
+		const size_t pos = 1 + static_cast<size_t>(Uniform() * (talker.size() + body.size()));
+		sentence[pos] = (sentence[pos] == '0') ? '1' : '0';
+	}
+	if ((_partialRate > 0) && (Uniform() < _partialRate))
+		sentence.resize(1 + static_cast<size_t>(Uniform() * (sentence.size() - 2)));  // at least the $, never the CR-LF
+
+	s += sentence;
+}
+
+void GPSLib::NMEAGenerator::NextEpoch(std::string &s) {
+	const boost::posix_time::time_duration timeOfDay = _time.time_of_day();
+	const double hdop = 1.3, vdop = 1.8, pdop = std::sqrt(hdop*hdop + vdop*vdop);
+
+	if (_sentenceMask & SM_GGA) {
+		std::ostringstream os;
+		os << "GGA,";
+		AppendTime(os, timeOfDay);
+		os << ',';
+		AppendLatLng(os, _latitude, 2, 'N', 'S');
+		os << ',';
+		AppendLatLng(os, _longitude, 3, 'E', 'W');
+		os << ",1," << std::setw(2) << ActiveSatellites << ',' << std::setprecision(1) << hdop << ',' << _altitude << ",M,-33.7,M,0.0,0000";
+		Append(s, os.str());
+	}
+
+	if (_sentenceMask & SM_GLL) {
+		std::ostringstream os;
+		os << "GLL,";
+		AppendLatLng(os, _latitude, 2, 'N', 'S');
+		os << ',';
+		AppendLatLng(os, _longitude, 3, 'E', 'W');
+		os << ',';
+		AppendTime(os, timeOfDay);
+		os << ",A";
+		Append(s, os.str());
+	}
+
+	if (_sentenceMask & SM_GSA) {
+		std::ostringstream os;
+		os << "GSA,A,3,";
+		for (int i = 0; i < 12; i++) {
+			if (i < ActiveSatellites)
+				os << std::setfill('0') << std::setw(2) << Sky[i]._prn;
+			os << ',';
+		}
+		os << std::fixed << std::setprecision(1) << pdop << ',' << hdop << ',' << vdop;
+		Append(s, os.str());
+	}
+
+	if (_sentenceMask & SM_GSV) {
+		const int totalMessages = (SkySize + SatellitesPerGSV - 1) / SatellitesPerGSV;
+		const int rotation = static_cast<int>(timeOfDay.total_seconds() / 240);  // the sky turns a degree every 4 minutes
+		for (int message = 0; message < totalMessages; message++) {
+			std::ostringstream os;
+			os << "GSV," << totalMessages << ',' << (message + 1) << ',' << std::setfill('0') << std::setw(2) << SkySize;
+			for (int i = message * SatellitesPerGSV; (i < SkySize) && (i < (message + 1) * SatellitesPerGSV); i++)
+				os << ',' << std::setw(2) << Sky[i]._prn << ',' << std::setw(2) << Sky[i]._elevation << ',' << std::setw(3) << ((Sky[i]._azimuth + rotation) % 360)
+					<< ',' << std::setw(2) << Sky[i]._snr;
+			Append(s, os.str());
+		}
+	}
+
+	if (_sentenceMask & SM_RMC) {
+		std::ostringstream os;
+		os << "RMC,";
+		AppendTime(os, timeOfDay);
+		os << ",A,";
+		AppendLatLng(os, _latitude, 2, 'N', 'S');
+		os << ',';
+		AppendLatLng(os, _longitude, 3, 'E', 'W');
+		os << ',' << std::setprecision(6) << _speed << ',' << std::setprecision(2) << _course << ',';
+		AppendDate(os, _time.date());
+		os << ",,";
+		Append(s, os.str());
+	}
+
+	Advance();
+}
+
+void GPSLib::NMEAGenerator::Advance() {
+	// dead reckon to the next epoch - a nautical mile is a minute of latitude
+	const double dt = 1.0 / _rate;
+	const double distance = _speed * dt / 3600.0 / 60.0;  // degrees of latitude
+	_latitude += distance * std::cos(_course * Pi / 180.0);
+	_longitude += distance * std::sin(_course * Pi / 180.0) / std::cos(_latitude * Pi / 180.0);
+	_course = std::fmod(_course + _turnRate * dt + 360.0, 360.0);
+	_time += boost::posix_time::microseconds(static_cast<boost::int64_t>(dt * 1000000.0));
+}
+
+std::string GPSLib::NMEAGenerator::Generate(size_t numEpochs) {
+	std::string s;
+	for (size_t i = 0; i < numEpochs; i++)
+		NextEpoch(s);
+	return s;
+}
+
+void GPSLib::NMEAGenerator::NextUBXEpoch(std::string &s) {
+	const boost::posix_time::time_duration timeOfDay = _time.time_of_day();
+	const double hdop = 1.3, vdop = 1.8, pdop = std::sqrt(hdop*hdop + vdop*vdop);
+	const unsigned int iTOW = static_cast<unsigned int>(((_time.date().day_of_week() * 24 * 3600) + timeOfDay.total_seconds()) * 1000 + (timeOfDay.total_milliseconds() % 1000));
+
+	std::vector<unsigned char> dop(18);
+	PutU4(dop, 0, iTOW);
+	PutU2(dop, 6, static_cast<unsigned int>(pdop * 100 + 0.5));
+	PutU2(dop, 10, static_cast<unsigned int>(vdop * 100 + 0.5));
+	PutU2(dop, 12, static_cast<unsigned int>(hdop * 100 + 0.5));
+	AppendUBX(s, UBX_NAV, UBX_NAV_DOP, dop);
+	_sentenceCount++;
+
+	std::vector<unsigned char> pvt(92);
+	PutU4(pvt, 0, iTOW);
+	PutU2(pvt, 4, _time.date().year());
+	pvt[6] = static_cast<unsigned char>(_time.date().month());
+	pvt[7] = static_cast<unsigned char>(_time.date().day());
+	pvt[8] = static_cast<unsigned char>(timeOfDay.hours());
+	pvt[9] = static_cast<unsigned char>(timeOfDay.minutes());
+	pvt[10] = static_cast<unsigned char>(timeOfDay.seconds());
+	pvt[11] = 0x03;  // date and time valid
+	PutU4(pvt, 16, static_cast<unsigned int>((timeOfDay.total_milliseconds() % 1000) * 1000000));
+	pvt[20] = 3;  // 3D fix
+	pvt[21] = 0x01;  // gnssFixOK
+	pvt[23] = ActiveSatellites;
+	PutU4(pvt, 24, static_cast<unsigned int>(static_cast<int>(std::floor(_longitude * 1e7 + 0.5))));
+	PutU4(pvt, 28, static_cast<unsigned int>(static_cast<int>(std::floor(_latitude * 1e7 + 0.5))));
+	PutU4(pvt, 32, static_cast<unsigned int>(static_cast<int>((_altitude - 33.7) * 1000)));
+	PutU4(pvt, 36, static_cast<unsigned int>(static_cast<int>(_altitude * 1000)));
+	PutU4(pvt, 60, static_cast<unsigned int>(_speed * 1852.0 / 3600.0 * 1000.0 + 0.5));  // knots to mm/s
+	PutU4(pvt, 64, static_cast<unsigned int>(_course * 1e5 + 0.5));
+	PutU2(pvt, 76, static_cast<unsigned int>(pdop * 100 + 0.5));
+	AppendUBX(s, UBX_NAV, UBX_NAV_PVT, pvt);
+	_sentenceCount++;
+
+	const int rotation = static_cast<int>(timeOfDay.total_seconds() / 240);
+	std::vector<unsigned char> sat(8 + 12 * SkySize);
+	PutU4(sat, 0, iTOW);
+	sat[4] = 1;  // version
+	sat[5] = SkySize;
+	for (int i = 0; i < SkySize; i++) {
+		const size_t offset = 8 + 12 * i;
+		sat[offset] = 0;  // GPS
+		sat[offset+1] = Sky[i]._prn;
+		sat[offset+2] = Sky[i]._snr;
+		sat[offset+3] = Sky[i]._elevation;
+		PutU2(sat, offset+4, (Sky[i]._azimuth + rotation) % 360);
+		PutU4(sat, offset+8, (i < ActiveSatellites) ? 0x08 : 0);  // svUsed
+	}
+	AppendUBX(s, UBX_NAV, UBX_NAV_SAT, sat);
+	_sentenceCount++;
+
+	Advance();
+}
+
+std::string GPSLib::NMEAGenerator::GenerateUBX(size_t numEpochs) {
+	std::string s;
+	for (size_t i = 0; i < numEpochs; i++)
+		NextUBXEpoch(s);
+	return s;
+}
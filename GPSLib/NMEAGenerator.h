@@ -0,0 +1,60 @@
+#ifndef __NMEAGENERATOR_H__
+#define __NMEAGENERATOR_H__
+
+#include <string>
+#include <vector>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "SentenceView.h"
+#include "UBX.h"
+#include "GPSLib_Export.h"
+
+namespace GPSLib {
+	// Generates valid, checksummed sentences along a simulated trajectory, for load and throughput testing.  Each
+	// epoch (1/rate seconds) produces one of each wanted sentence type, in the order a receiver sends them, and moves
+	// the position along the current course.  Sentences can be corrupted (a changed character, so the checksum no
+	// longer matches) or cut short (no CR-LF) at a given rate.  The same seed always produces the same output.
+	class GPSLib_Export NMEAGenerator {
+		boost::random::mt19937 _random;
+		boost::posix_time::ptime _time;
+		double _latitude, _longitude, _altitude;  // decimal degrees, meters
+		double _speed, _course, _turnRate;  // knots, degrees true, degrees per second
+		double _rate;  // epochs per second
+		unsigned int _sentenceMask;
+		std::vector<std::string> _talkers;
+		double _corruptRate, _partialRate;
+		size_t _sentenceCount, _talkerIndex;
+
+		double Uniform();
+		void Append(std::string &s, const std::string &body);
+		void Advance();
+	public:
+		NMEAGenerator(double latitude, double longitude, double speed, double course,
+			const boost::posix_time::ptime &start = boost::posix_time::ptime(boost::gregorian::date(2013, 1, 15), boost::posix_time::hours(19)),
+			unsigned int seed = 1);
+
+		void SetRate(double epochsPerSecond) { _rate = epochsPerSecond; }
+		void SetSentences(unsigned int sentenceMask) { _sentenceMask = sentenceMask; }
+		void SetTalkers(const std::vector<std::string> &talkers) { _talkers = talkers; }  // used in turn, sentence by sentence
+		void SetTurnRate(double degreesPerSecond) { _turnRate = degreesPerSecond; }
+		// fraction (0-1) of sentences with a bad checksum, and of sentences cut off before their CR-LF
+		void SetCorruption(double corruptRate, double partialRate) { _corruptRate = corruptRate; _partialRate = partialRate; }
+
+		// append the sentences of one epoch to s, then advance the trajectory by one epoch
+		void NextEpoch(std::string &s);
+		std::string Generate(size_t numEpochs);
+		// the same epoch as u-blox binary UBX NAV-DOP, NAV-PVT and NAV-SAT frames, ignoring the sentence, talker and
+		// corruption settings
+		void NextUBXEpoch(std::string &s);
+		std::string GenerateUBX(size_t numEpochs);
+
+		const boost::posix_time::ptime &GetTime() const { return _time; }
+		double GetLatitude() const { return _latitude; }
+		double GetLongitude() const { return _longitude; }
+		size_t GetSentenceCount() const { return _sentenceCount; }  // sentences (or UBX frames) generated, including corrupted and partial ones
+
+		// $, body, *, checksum and CR-LF
+		static std::string MakeSentence(const std::string &body);
+	};
+}
+#endif
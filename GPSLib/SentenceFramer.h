@@ -0,0 +1,93 @@
+#ifndef __SENTENCEFRAMER_H__
+#define __SENTENCEFRAMER_H__
+
+#include "SentenceView.h"
+#include "CharClass.h"
+
+namespace GPSLib {
+	// Frames sentences out of a byte stream into a fixed-size buffer, so the framing state of a stream is small
+	// and never allocates.  A sentence whose type isn't wanted is dropped as soon as its address is seen, one
+	// that outgrows the buffer is dropped, with framing picking up again at the next $, and one that is cut
+	// short by the $ of the next is dropped in favor of the next.
+	class SentenceFramer {
+	public:
+		enum { MaxSentenceLength = 128, AddressLength = 5 };  // NMEA allows 82 chars, but receivers don't always keep to that
+		enum Result {
+			Framing,
+			Complete,  // the sentence is in GetSentence() until the next call
+			TooLong,  // the sentence in progress outgrew the buffer and was dropped
+			Truncated  // a $ arrived before the CR-LF of the sentence in progress, which was dropped
+		};
+	private:
+		enum State { InSentence, Done, SkipToLF, SkipToDollar };
+		char _buffer[MaxSentenceLength];
+		unsigned char _length;
+		unsigned char _addressPos;  // position in _buffer following the $ of the sentence in progress, 0 if no $ yet
+		unsigned char _state;
+
+		void Reset() { _length = 0; _addressPos = 0; _state = InSentence; }
+	public:
+		SentenceFramer() { Reset(); }
+
+		// add one byte, saying what it did to the sentence in progress
+		Result Add(unsigned char c, unsigned int wantedSentences) {
+			switch (_state) {
+			case Done:
+				Reset();
+				break;
+			case SkipToLF:
+				if (c == '\n')  // the LF ends the unwanted sentence
+					Reset();
+				else if (c == '$') {  // the unwanted sentence was cut short, and this starts the next
+					Reset();
+					break;
+				}
+				return Framing;
+			case SkipToDollar:
+				if (c != '$')
+					return Framing;
+				Reset();
+				break;
+			}
+
+			if (!IsNMEAChar(c))  // a sentence is ASCII plus CR-LF - ignore anything out of that range
+				return Framing;
+
+			Result result = Framing;
+			if (c == '$') {
+				// no $ inside a sentence, so anything before this one is noise or a sentence that was cut short
+				if (_addressPos != 0)
+					result = Truncated;
+				Reset();
+			}
+
+			if (_length == MaxSentenceLength) {
+				// too long to be a sentence - drop it, and start again at the next $
+				_state = SkipToDollar;
+				return TooLong;
+			}
+			_buffer[_length++] = c;
+
+			if ((c == '$') && (_addressPos == 0))
+				_addressPos = _length;
+			else if ((_addressPos != 0) && (_length == _addressPos + AddressLength)) {
+				// the sentence type is now known, so drop the sentence before any checksum or decode work if no one wants it
+				const unsigned int sentenceType = SentenceTypeFromAddress(_buffer + _addressPos);
+				if ((sentenceType != SM_NONE) && !(sentenceType & wantedSentences)) {
+					_state = SkipToLF;
+					return result;
+				}
+			}
+
+			if ((c == '\n') && (_length >= 2) && (_buffer[_length-2] == '\r')) {  // \r\n ends a sentence
+				_state = Done;
+				return Complete;
+			}
+			return result;
+		}
+
+		const char *GetSentence() const { return _buffer; }
+		size_t GetLength() const { return _length; }
+	};
+}
+#endif
@@ -0,0 +1,324 @@
+#include "SentenceView.h"
+#include "Util.h"
+#include "CharClass.h"
+#include <algorithm>
+#include <boost/integer_traits.hpp>
+
+unsigned int GPSLib::SentenceTypeFromAddress(const char *address) {
+	if ((address[0] != 'G') || (address[1] != 'P'))
+		return SM_NONE;
+	const char *type = address+2;
+	if (std::equal(type, type+3, "GGA")) return SM_GGA;
+	if (std::equal(type, type+3, "GLL")) return SM_GLL;
+	if (std::equal(type, type+3, "RMC")) return SM_RMC;
+	if (std::equal(type, type+3, "GSV")) return SM_GSV;
+	if (std::equal(type, type+3, "GSA")) return SM_GSA;
+	return SM_NONE;
+}
+
+
+namespace {
+	using GPSLib::IsDigit;
+	using GPSLib::HexValue;
+
+	// value of the digits in [begin, end) - false if any aren't digits
+	bool ParseDigits(const char *begin, const char *end, int &value) {
+		int v = 0;
+		for (const char *p = begin; p != end; ++p) {
+			const int digit = GPSLib::DigitValue(*p);
+			if (digit < 0)
+				return false;
+			v = v*10 + digit;
+		}
+		value = v;
+		return true;
+	}
+
+	// [-]ddd[.ddd] without going through a stream - the digits are accumulated as an integer and scaled once,
+	// so the result is as exact as the conversion of the text would be
+	bool ParseDecimal(const char *begin, const char *end, double &value) {
+		static const double powersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18 };
+		const char *p = begin;
+		const bool negative = (p != end) && (*p == '-');
+		if ((p != end) && ((*p == '-') || (*p == '+')))
+			++p;
+
+		boost::uint64_t mantissa = 0;
+		int numDigits = 0, fractionDigits = 0;
+		bool inFraction = false;
+		for (; p != end; ++p) {
+			if (IsDigit(*p)) {
+				if (numDigits == 18)
+					return false;  // more precision than any NMEA field has
+				mantissa = mantissa*10 + (*p - '0');
+				numDigits++;
+				if (inFraction)
+					fractionDigits++;
+			} else if ((*p == '.') && !inFraction)
+				inFraction = true;
+			else
+				return false;
+		}
+		if (numDigits == 0)
+			return false;
+
+		const double v = static_cast<double>(mantissa) / powersOf10[fractionDigits];
+		value = negative ? -v : v;
+		return true;
+	}
+
+	// [-]ddd[.ddd] as an integer number of 10^-decimals, rounded half away from zero on the first digit dropped
+	bool ParseScaled(const char *begin, const char *end, int decimals, boost::int64_t &value) {
+		const char *p = begin;
+		const bool negative = (p != end) && (*p == '-');
+		if ((p != end) && ((*p == '-') || (*p == '+')))
+			++p;
+
+		boost::int64_t v = 0;
+		int numDigits = 0, fractionDigits = 0;
+		bool inFraction = false, roundUp = false;
+		for (; p != end; ++p) {
+			if (IsDigit(*p)) {
+				if (inFraction && (fractionDigits >= decimals)) {  // beyond the precision wanted
+					if (fractionDigits++ == decimals)
+						roundUp = (*p >= '5');
+					continue;
+				}
+				if (++numDigits + decimals > 18)
+					return false;  // more than an int64 can hold
+				v = v*10 + (*p - '0');
+				if (inFraction)
+					fractionDigits++;
+			} else if ((*p == '.') && !inFraction)
+				inFraction = true;
+			else
+				return false;
+		}
+		if ((numDigits == 0) && (fractionDigits == 0))
+			return false;
+
+		for (; fractionDigits < decimals; fractionDigits++)
+			v *= 10;
+		if (roundUp)
+			v++;
+		value = negative ? -v : v;
+		return true;
+	}
+}
+
+
+GPSLib::SentenceView::SentenceView() : _sentence(0), _type(SM_NONE), _numFields(0) {}
+
+bool GPSLib::SentenceView::Parse(const char *begin, const char *end) {
+	RejectReason reason;
+	return Parse(begin, end, reason);
+}
+
+bool GPSLib::SentenceView::Parse(const char *begin, const char *end, RejectReason &reason) {
+	_sentence = 0;
+	_type = SM_NONE;
+	_numFields = 0;
+
+	// fail if can't find sentence boundary, or sentence too short
+	const char *dollar = std::find(begin, end, '$');
+	const char crlf[] = { '\r', '\n' };
+	const char *textEnd = std::search(begin, end, crlf, crlf+2);
+	if ((dollar == end) || (textEnd == end) || (textEnd < dollar + 5)) {
+		reason = RR_FRAMING;
+		return false;
+	}
+
+	const char *star = std::find(std::reverse_iterator<const char *>(textEnd), std::reverse_iterator<const char *>(dollar), '*').base() - 1;
+	if (star >= dollar) {
+		// have a checksum, so validate it - it is just prior to the CRLF
+		const int high = (star + 2 < end) ? HexValue(star[1]) : -1;
+		const int low = (star + 2 < end) ? HexValue(star[2]) : -1;
+		if ((high < 0) || (low < 0)) {
+			reason = RR_CHECKSUM;
+			return false;
+		}
+
+		unsigned char calculatedChecksum = 0;
+		std::for_each(dollar+1, star, [&calculatedChecksum](char c) { calculatedChecksum^=c; });  // +1, since only chars between $ *
+		if (calculatedChecksum != ((high << 4) | low)) {
+			reason = RR_CHECKSUM;
+			return false;
+		}
+
+		textEnd = star;
+	}
+
+	// fields run from the char following $ to before *, if it exists
+	if (textEnd - dollar > 0xFFFF) {
+		reason = RR_TOO_LONG;
+		return false;
+	}
+	_fieldBegin[0] = 1;
+	size_t numFields = 1;
+	for (const char *p = dollar+1; p != textEnd; ++p) {
+		if (*p == ',') {
+			if (numFields == MaxFields) {
+				reason = RR_TOO_MANY_FIELDS;
+				return false;
+			}
+			_fieldBegin[numFields++] = static_cast<unsigned short>(p - dollar + 1);
+		}
+	}
+	_fieldBegin[numFields] = static_cast<unsigned short>(textEnd - dollar + 1);
+
+	_sentence = dollar;
+	_numFields = numFields;
+	if (GetFieldEnd(0) - GetFieldBegin(0) == 5)
+		_type = SentenceTypeFromAddress(GetFieldBegin(0));
+	return true;
+}
+
+bool GPSLib::SentenceView::Equals(size_t field, const char *s) const {
+	if (field >= _numFields)
+		return false;
+	const char *p = GetFieldBegin(field), *fieldEnd = GetFieldEnd(field);
+	for (; (p != fieldEnd) && (*s != 0); ++p, ++s)
+		if (*p != *s)
+			return false;
+	return (p == fieldEnd) && (*s == 0);
+}
+
+bool GPSLib::SentenceView::GetString(size_t field, std::string &value) const {
+	if (field >= _numFields)
+		return false;
+	value.assign(GetFieldBegin(field), GetFieldEnd(field));
+	return true;
+}
+
+bool GPSLib::SentenceView::GetChar(size_t field, char &value) const {
+	if (IsEmpty(field))
+		return false;
+	value = *GetFieldBegin(field);
+	return true;
+}
+
+bool GPSLib::SentenceView::GetInt(size_t field, int &value) const {
+	if (IsEmpty(field))
+		return false;
+	const char *begin = GetFieldBegin(field);
+	const bool negative = (*begin == '-');
+	int v;
+	if (!ParseDigits(negative ? begin+1 : begin, GetFieldEnd(field), v) || (negative && (begin+1 == GetFieldEnd(field))))
+		return false;
+	value = negative ? -v : v;
+	return true;
+}
+
+bool GPSLib::SentenceView::GetDouble(size_t field, double &value) const {
+	return !IsEmpty(field) && ParseDecimal(GetFieldBegin(field), GetFieldEnd(field), value);
+}
+
+bool GPSLib::SentenceView::GetScaled(size_t field, int decimals, boost::int32_t &value) const {
+	boost::int64_t v;
+	if (IsEmpty(field) || !ParseScaled(GetFieldBegin(field), GetFieldEnd(field), decimals, v) ||
+		(v > boost::integer_traits<boost::int32_t>::const_max) || (v < boost::integer_traits<boost::int32_t>::const_min))
+		return false;
+	value = static_cast<boost::int32_t>(v);
+	return true;
+}
+
+bool GPSLib::SentenceView::GetTime(size_t field, boost::posix_time::time_duration &value) const {
+	int milliseconds;
+	if (!GetTimeOfDay(field, milliseconds))
+		return false;
+	value = boost::posix_time::milliseconds(milliseconds);
+	return true;
+}
+
+bool GPSLib::SentenceView::GetTimeOfDay(size_t field, int &value) const {
+	// hhmmss, optionally followed by a fraction of a second
+	if (IsEmpty(field))
+		return false;
+	const char *begin = GetFieldBegin(field), *end = GetFieldEnd(field);
+	int hours, minutes, seconds;
+	if ((end - begin < 6) || !ParseDigits(begin, begin+2, hours) || !ParseDigits(begin+2, begin+4, minutes) || !ParseDigits(begin+4, begin+6, seconds) ||
+		(hours > 23) || (minutes > 59) || (seconds > 60))  // 60 for a leap second
+		return false;
+
+	int milliseconds = 0;
+	if (end - begin > 6) {
+		if (begin[6] != '.')
+			return false;
+		// only the first three digits of the fraction matter
+		int scale = 100;
+		for (const char *p = begin+7; p != end; ++p, scale /= 10) {
+			if (!IsDigit(*p))
+				return false;
+			milliseconds += (*p - '0') * scale;
+		}
+	}
+
+	value = ((hours*60 + minutes)*60 + seconds)*1000 + milliseconds;
+	return true;
+}
+
+bool GPSLib::SentenceView::GetLatLng(size_t field, double &value) const {
+	// the last two digits before the decimal point, and the fraction, are minutes - the digits ahead of them are degrees
+	if (IsEmpty(field))
+		return false;
+	const char *begin = GetFieldBegin(field), *end = GetFieldEnd(field);
+	const char *point = std::find(begin, end, '.');
+	int degrees;
+	double minutes;
+	if ((point == end) || (point+1 == end) || (point - begin < 4) || (point - begin > 5) ||
+		!ParseDigits(begin, point-2, degrees) || (degrees > 180) || !IsDigit(point[-2]) || (point[-2] > '5') ||
+		!ParseDecimal(point-2, end, minutes))
+		return false;
+
+	char hemisphere = 0;
+	GetChar(field+1, hemisphere);
+	value = GPSLib::ToDecimalDegree(degrees, minutes, hemisphere);
+	return true;
+}
+
+bool GPSLib::SentenceView::GetLatLng(size_t field, FixedCoordinate &value) const {
+	// as above, with the minutes read to 1e-7 of a minute, so dividing by 60 leaves them to the nearest 1e-7 degree
+	if (IsEmpty(field))
+		return false;
+	const char *begin = GetFieldBegin(field), *end = GetFieldEnd(field);
+	const char *point = std::find(begin, end, '.');
+	int degrees;
+	boost::int64_t minutes;
+	if ((point == end) || (point+1 == end) || (point - begin < 4) || (point - begin > 5) ||
+		!ParseDigits(begin, point-2, degrees) || (degrees > 180) || !IsDigit(point[-2]) || (point[-2] > '5') ||
+		!ParseScaled(point-2, end, 7, minutes))
+		return false;
+
+	char hemisphere = 0;
+	GetChar(field+1, hemisphere);
+	const boost::int32_t v = static_cast<boost::int32_t>(degrees * static_cast<boost::int64_t>(FixedCoordinate::Scale) + (minutes + 30) / 60);
+	value = FixedCoordinate(((hemisphere == 'S') || (hemisphere == 'W')) ? -v : v);
+	return true;
+}
+
+bool GPSLib::SentenceView::GetYearMonthDay(size_t field, int &year, int &month, int &day) const {
+	// ddmmyy
+	if (IsEmpty(field))
+		return false;
+	const char *begin = GetFieldBegin(field);
+	if ((GetFieldEnd(field) - begin != 6) || !ParseDigits(begin, begin+2, day) || !ParseDigits(begin+2, begin+4, month) || !ParseDigits(begin+4, begin+6, year))
+		return false;
+	year += 2000;
+	return (month >= 1) && (month <= 12) && (day >= 1) && (day <= boost::gregorian::gregorian_calendar::end_of_month_day(year, month));
+}
+
+bool GPSLib::SentenceView::GetDate(size_t field, boost::gregorian::date &value) const {
+	int year, month, day;
+	if (!GetYearMonthDay(field, year, month, day))
+		return false;
+	value = boost::gregorian::date(year, month, day);
+	return true;
+}
+
+bool GPSLib::SentenceView::GetDaysSinceEpoch(size_t field, int &value) const {
+	int year, month, day;
+	if (!GetYearMonthDay(field, year, month, day))
+		return false;
+	value = DaysSinceEpoch(year, month, day);
+	return true;
+}
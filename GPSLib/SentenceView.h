@@ -0,0 +1,89 @@
+#ifndef __SENTENCEVIEW_H__
+#define __SENTENCEVIEW_H__
+
+#include <string>
+#include <boost/date_time.hpp>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include <boost/cstdint.hpp>
+#include "FixedPoint.h"
+#include "GPSLib_Export.h"
+
+namespace GPSLib {
+	// sentence types as bits, so a decoder can be told which sentences to decode
+	enum SentenceMask {
+		SM_NONE = 0x00,
+		SM_GGA = 0x01,
+		SM_GLL = 0x02,
+		SM_RMC = 0x04,
+		SM_GSV = 0x08,
+		SM_GSA = 0x10,
+		SM_ALL = SM_GGA | SM_GLL | SM_RMC | SM_GSV | SM_GSA,
+		SM_INSTALLED_HANDLERS = 0x80000000  // decode only the sentences that have an On* handler installed
+	};
+
+	// why a sentence (or UBX frame) was rejected
+	enum RejectReason {
+		RR_FRAMING,  // no $ or CR-LF, or too short to hold an address
+		RR_CHECKSUM,
+		RR_TOO_MANY_FIELDS,
+		RR_TOO_LONG,  // outgrew the maximum sentence length before its CR-LF
+		RR_TRUNCATED,  // cut short by the $ of the next sentence
+		RR_UNKNOWN_TYPE,  // valid, but not a sentence that can be decoded
+		RR_BAD_FIELD,  // a field needed by the decode is missing or malformed
+		RR_UBX_INVALID,  // UBX frame with a bad checksum or length
+		RR_COUNT
+	};
+
+	// map a sentence address, such as GPGGA, to its SentenceMask bit - SM_NONE if the sentence is not one that can be decoded
+	GPSLib_Export unsigned int SentenceTypeFromAddress(const char *address);
+
+	// field indexes of the sentences a SentenceView can be over - field 0 is the address, such as GPGGA
+	struct GGAFields { enum { Time = 1, Latitude = 2, Longitude = 4, Quality = 6, NumSatellites = 7, HorizontalDilution = 8, Altitude = 9 }; };
+	struct GLLFields { enum { Latitude = 1, Longitude = 3, Time = 5, Validity = 6 }; };
+	struct RMCFields { enum { Time = 1, Validity = 2, Latitude = 3, Longitude = 5, Speed = 7, Course = 8, Date = 9 }; };
+	struct GSVFields { enum { TotalMessages = 1, MessageNumber = 2, TotalSatellitesInView = 3, FirstSatellite = 4 }; };
+	struct GSAFields { enum { Mode = 1, Fix = 2, FirstSatellite = 3, PDOP = 15, HDOP = 16, VDOP = 17 }; };
+
+	// A checksum-validated sentence over the raw bytes it arrived in.  Fields are only located when the view
+	// is parsed, and are only converted when an accessor asks for them.  The view does not own the bytes, so it
+	// is only valid for as long as they are - inside an OnSentence callback, for the duration of the callback.
+	class GPSLib_Export SentenceView {
+	public:
+		enum { MaxFields = 40 };
+	private:
+		const char *_sentence;  // the $ that starts the sentence
+		unsigned int _type;  // SentenceMask bit of the sentence, SM_NONE if it isn't one that can be decoded
+		size_t _numFields;
+		unsigned short _fieldBegin[MaxFields+1];  // offset from _sentence of each field, plus one past the separator of the last
+
+	public:
+		SentenceView();
+
+		// locate the sentence in [begin, end), validate its checksum and find its fields - false if it isn't a valid sentence
+		bool Parse(const char *begin, const char *end);
+		bool Parse(const char *begin, const char *end, RejectReason &reason);  // and why, if it isn't
+
+		unsigned int GetType() const { return _type; }
+		size_t GetNumFields() const { return _numFields; }
+		const char *GetFieldBegin(size_t field) const { return _sentence + _fieldBegin[field]; }
+		const char *GetFieldEnd(size_t field) const { return _sentence + _fieldBegin[field+1] - 1; }  // -1 for the separator
+		bool IsEmpty(size_t field) const { return (field >= _numFields) || (GetFieldBegin(field) == GetFieldEnd(field)); }
+		bool Equals(size_t field, const char *s) const;
+
+		// accessors return false, and leave value untouched, if the field is missing, empty or malformed
+		bool GetString(size_t field, std::string &value) const;
+		bool GetChar(size_t field, char &value) const;
+		bool GetInt(size_t field, int &value) const;
+		bool GetDouble(size_t field, double &value) const;
+		bool GetScaled(size_t field, int decimals, boost::int32_t &value) const;  // [-]ddd[.ddd] times 10^decimals, rounded, without floating point
+		bool GetTime(size_t field, boost::posix_time::time_duration &value) const;  // hhmmss.sss
+		bool GetTimeOfDay(size_t field, int &value) const;  // hhmmss.sss, as milliseconds since midnight
+		bool GetLatLng(size_t field, double &value) const;  // (d)ddmm.mmmm in field, hemisphere in field+1
+		bool GetLatLng(size_t field, FixedCoordinate &value) const;  // the same, without floating point
+		bool GetDate(size_t field, boost::gregorian::date &value) const;  // ddmmyy
+		bool GetDaysSinceEpoch(size_t field, int &value) const;  // ddmmyy, as days since 1970-01-01
+	private:
+		bool GetYearMonthDay(size_t field, int &year, int &month, int &day) const;
+	};
+}
+#endif
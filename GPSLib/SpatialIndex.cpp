@@ -0,0 +1,166 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+#include "Geodesy.h"
+
+namespace {
+	bool InLongitudes(double longitude, double west, double east) {
+		return (west <= east) ? ((longitude >= west) && (longitude <= east)) : ((longitude >= west) || (longitude <= east));
+	}
+}
+
+GPSLib::SpatialIndex::SpatialIndex(double cellDegrees) : _cellDegrees(cellDegrees),
+	_rows(static_cast<long>(std::ceil(180.0 / cellDegrees))), _columns(static_cast<long>(std::ceil(360.0 / cellDegrees))) {}
+
+long GPSLib::SpatialIndex::Row(double latitude) const {
+	const long row = static_cast<long>(std::floor((latitude + 90.0) / _cellDegrees));
+	return std::max(0L, std::min(_rows - 1, row));
+}
+
+long GPSLib::SpatialIndex::Column(double longitude) const {
+	double x = std::fmod(longitude + 180.0, 360.0);
+	if (x < 0)
+		x += 360.0;
+	return std::min(_columns - 1, static_cast<long>(std::floor(x / _cellDegrees)));
+}
+
+void GPSLib::SpatialIndex::Candidates(long firstRow, long lastRow, long firstColumn, long lastColumn, std::vector<size_t> &candidates) const {
+	const long columns = (firstColumn <= lastColumn) ? lastColumn - firstColumn + 1 : _columns - firstColumn + lastColumn + 1;
+	if (static_cast<double>(lastRow - firstRow + 1) * columns > _cells.size()) {
+		for (Cells::const_iterator it = _cells.begin(); it != _cells.end(); ++it)
+			candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+		return;
+	}
+
+	for (long row = firstRow; row <= lastRow; row++)
+		for (long c = 0; c < columns; c++) {
+			const Cells::const_iterator it = _cells.find(Cell(row, (firstColumn + c) % _columns));
+			if (it != _cells.end())
+				candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+		}
+}
+
+void GPSLib::SpatialIndex::Update(const std::string &sensorID, double latitude, double longitude) {
+	const boost::uint64_t cell = Cell(Row(latitude), Column(longitude));
+	boost::unique_lock<boost::shared_mutex> lock(_indexMutex);
+
+	const std::pair<boost::unordered_map<std::string, size_t>::iterator, bool> added = _sensors.insert(std::make_pair(sensorID, _entries.size()));
+	if (added.second) {
+		std::vector<size_t> &slots = _cells[cell];
+		Entry entry;
+		entry._sensorID = sensorID;
+		entry._cell = cell;
+		entry._slot = slots.size();
+		_entries.push_back(entry);
+		slots.push_back(added.first->second);
+	}
+
+	Entry &entry = _entries[added.first->second];
+	entry._latitude = latitude;
+	entry._longitude = longitude;
+	if (entry._cell == cell)
+		return;
+
+	// moved cells - the last of the old cell's list takes its slot
+	const Cells::iterator from = _cells.find(entry._cell);
+	std::vector<size_t> &slots = from->second;
+	slots[entry._slot] = slots.back();
+	_entries[slots[entry._slot]]._slot = entry._slot;
+	slots.pop_back();
+	if (slots.empty())
+		_cells.erase(from);
+
+	std::vector<size_t> &to = _cells[cell];
+	entry._cell = cell;
+	entry._slot = to.size();
+	to.push_back(added.first->second);
+}
+
+size_t GPSLib::SpatialIndex::GetSize() const {
+	boost::shared_lock<boost::shared_mutex> lock(_indexMutex);
+	return _entries.size();
+}
+
+void GPSLib::SpatialIndex::InBox(double south, double west, double north, double east, std::vector<SpatialMatch> &matches) const {
+	boost::shared_lock<boost::shared_mutex> lock(_indexMutex);
+	std::vector<size_t> candidates;
+	Candidates(Row(south), Row(north), Column(west), Column(east), candidates);
+	for (size_t i = 0; i < candidates.size(); i++) {
+		const Entry &entry = _entries[candidates[i]];
+		if ((entry._latitude >= south) && (entry._latitude <= north) && InLongitudes(entry._longitude, west, east))
+			matches.push_back(SpatialMatch(entry._sensorID, entry._latitude, entry._longitude, 0));
+	}
+}
+
+void GPSLib::SpatialIndex::InRadius(double latitude, double longitude, double meters, std::vector<SpatialMatch> &matches) const {
+	// the box around the circle - every longitude if it reaches a pole
+	const double radians = meters / EarthMeanRadius;
+	const double south = std::max(-90.0, latitude - radians * RadiansToDegrees), north = std::min(90.0, latitude + radians * RadiansToDegrees);
+	double west = -180.0, east = 180.0;
+	const double sinRadius = std::sin(std::min(radians, Pi / 2.0)), cosLatitude = std::cos(latitude * DegreesToRadians);
+	if ((south > -90.0) && (north < 90.0) && (sinRadius < cosLatitude)) {
+		const double degrees = std::asin(sinRadius / cosLatitude) * RadiansToDegrees;
+		west = std::fmod(longitude - degrees + 540.0, 360.0) - 180.0;
+		east = std::fmod(longitude + degrees + 540.0, 360.0) - 180.0;
+	}
+
+	boost::shared_lock<boost::shared_mutex> lock(_indexMutex);
+	std::vector<size_t> candidates;
+	Candidates(Row(south), Row(north), Column(west), (east == 180.0) ? _columns - 1 : Column(east), candidates);
+	for (size_t i = 0; i < candidates.size(); i++) {
+		const Entry &entry = _entries[candidates[i]];
+		const double distance = HaversineDistance(latitude, longitude, entry._latitude, entry._longitude);
+		if (distance <= meters)
+			matches.push_back(SpatialMatch(entry._sensorID, entry._latitude, entry._longitude, distance));
+	}
+}
+
+void GPSLib::SpatialIndex::Nearest(double latitude, double longitude, size_t k, std::vector<SpatialMatch> &matches) const {
+	boost::shared_lock<boost::shared_mutex> lock(_indexMutex);
+	if ((k == 0) || _entries.empty())
+		return;
+
+	// rings of cells outward from the point's own, until the kth nearest found so far is nearer than anything in the
+	// rings beyond could be
+	const long row = Row(latitude), column = Column(longitude);
+	const double cellMeters = _cellDegrees * DegreesToRadians * EarthMeanRadius;
+	std::vector<std::pair<double, size_t> > found;
+	for (long ring = 0; found.size() < _entries.size(); ring++) {
+		if ((8.0 * ring > _cells.size()) || (2 * ring + 1 >= _rows) || (2 * ring + 1 >= _columns)) {
+			// the ring is more cells than are occupied - every sensor is cheaper
+			found.clear();
+			for (size_t i = 0; i < _entries.size(); i++)
+				found.push_back(std::make_pair(HaversineDistance(latitude, longitude, _entries[i]._latitude, _entries[i]._longitude), i));
+			break;
+		}
+
+		for (long r = row - ring; r <= row + ring; r++) {
+			if ((r < 0) || (r >= _rows))
+				continue;
+			const long step = ((r == row - ring) || (r == row + ring)) ? 1 : 2 * ring;  // the sides of the ring only
+			for (long c = column - ring; c <= column + ring; c += step) {
+				const Cells::const_iterator it = _cells.find(Cell(r, (c % _columns + _columns) % _columns));
+				if (it == _cells.end())
+					continue;
+				for (size_t i = 0; i < it->second.size(); i++) {
+					const Entry &entry = _entries[it->second[i]];
+					found.push_back(std::make_pair(HaversineDistance(latitude, longitude, entry._latitude, entry._longitude), it->second[i]));
+				}
+			}
+		}
+
+		if (found.size() >= k) {
+			std::nth_element(found.begin(), found.begin() + (k - 1), found.end());
+			const double edgeLatitude = std::min(90.0, std::fabs(latitude) + (ring + 1) * _cellDegrees);
+			if (found[k - 1].first <= ring * cellMeters * std::cos(edgeLatitude * DegreesToRadians))
+				break;
+		}
+	}
+
+	const size_t n = std::min(k, found.size());
+	std::partial_sort(found.begin(), found.begin() + n, found.end());
+	for (size_t i = 0; i < n; i++) {
+		const Entry &entry = _entries[found[i].second];
+		matches.push_back(SpatialMatch(entry._sensorID, entry._latitude, entry._longitude, found[i].first));
+	}
+}
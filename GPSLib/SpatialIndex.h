@@ -0,0 +1,64 @@
+#ifndef __SPATIALINDEX_H__
+#define __SPATIALINDEX_H__
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include "GPSLib_Export.h"
+
+namespace GPSLib {
+	// a sensor found by a SpatialIndex query
+	class SpatialMatch {
+	public:
+		std::string _sensorID;
+		double _latitude, _longitude;
+		double _distance;  // meters from the query's point, 0 for a bounding box
+
+		SpatialMatch(const std::string &sensorID, double latitude, double longitude, double distance) :
+			_sensorID(sensorID), _latitude(latitude), _longitude(longitude), _distance(distance) {}
+	};
+
+	// The latest position of each sensor, bucketed in a grid of cellDegrees square cells so a query only looks at the
+	// cells it overlaps, not every sensor.  Only occupied cells take memory.  A query covering more cells than are
+	// occupied looks at every sensor instead.  Distances are haversine, on the mean earth radius.  Positions may be
+	// updated and queried from any threads - queries share the index's lock, so only wait on updates.
+	class GPSLib_Export SpatialIndex : private boost::noncopyable {
+		class Entry {
+		public:
+			std::string _sensorID;
+			double _latitude, _longitude;
+			boost::uint64_t _cell;
+			size_t _slot;  // position in its cell's list
+		};
+
+		typedef boost::unordered_map<boost::uint64_t, std::vector<size_t> > Cells;  // by cell, indexes into _entries
+		const double _cellDegrees;
+		const long _rows, _columns;
+		mutable boost::shared_mutex _indexMutex;
+		std::vector<Entry> _entries;
+		boost::unordered_map<std::string, size_t> _sensors;  // index into _entries
+		Cells _cells;
+
+		long Row(double latitude) const;
+		long Column(double longitude) const;
+		boost::uint64_t Cell(long row, long column) const { return static_cast<boost::uint64_t>(row) * _columns + column; }
+		// every sensor in cells rows by columns, where columns may wrap past 180 - or every sensor, if that is fewer cells
+		void Candidates(long firstRow, long lastRow, long firstColumn, long lastColumn, std::vector<size_t> &candidates) const;
+	public:
+		explicit SpatialIndex(double cellDegrees = 0.01);  // about 1km
+
+		void Update(const std::string &sensorID, double latitude, double longitude);
+		size_t GetSize() const;
+
+		// south to north, west to east, edges included - a west east of east crosses 180 - appended to matches
+		void InBox(double south, double west, double north, double east, std::vector<SpatialMatch> &matches) const;
+		// within meters of the point, appended to matches
+		void InRadius(double latitude, double longitude, double meters, std::vector<SpatialMatch> &matches) const;
+		// the k nearest the point, nearest first, appended to matches
+		void Nearest(double latitude, double longitude, size_t k, std::vector<SpatialMatch> &matches) const;
+	};
+}
+#endif
@@ -0,0 +1,55 @@
+#include "TopicStatistics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	// nearest rank - reorders latencies
+	double Percentile(std::vector<double> &latencies, double percentile) {
+		// the ceil(p/100 * n)th smallest, as a 0-based index
+		const double nearestRank = std::ceil(percentile * latencies.size() / 100.0);
+		const size_t rank = (nearestRank < 1) ? 0 : std::min(latencies.size() - 1, static_cast<size_t>(nearestRank) - 1);
+		std::nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+		return latencies[rank];
+	}
+}
+
+GPSLib::TopicStatistics::TopicStatistics() : _gaps(0), _missing(0),
+	_periodStart(boost::posix_time::microsec_clock::universal_time()) {}
+
+void GPSLib::TopicStatistics::Add(const std::string &sensorID, unsigned long sequence, double latency) {
+	boost::mutex::scoped_lock lock(_statisticsMutex);
+	_latencies.push_back(latency);
+	if (sequence == 0)
+		return;
+
+	unsigned long &last = _lastSequence[sensorID];
+	if ((last != 0) && (sequence > last + 1)) {
+		_gaps++;
+		_missing += sequence - last - 1;
+	}
+	last = sequence;  // one lower than the last starts again, as from a publisher that has been restarted
+}
+
+GPSLib::TopicSummary GPSLib::TopicStatistics::Take() {
+	boost::mutex::scoped_lock lock(_statisticsMutex);
+	const boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+	const double seconds = (now - _periodStart).total_microseconds() / 1e6;
+
+	TopicSummary summary;
+	summary._samples = _latencies.size();
+	summary._gaps = _gaps;
+	summary._missing = _missing;
+	summary._rate = (seconds > 0) ? summary._samples / seconds : 0;
+	summary._latency50 = summary._latency90 = summary._latency99 = summary._latencyMax = 0;
+	if (!_latencies.empty()) {
+		summary._latency50 = Percentile(_latencies, 50);
+		summary._latency90 = Percentile(_latencies, 90);
+		summary._latency99 = Percentile(_latencies, 99);
+		summary._latencyMax = *std::max_element(_latencies.begin(), _latencies.end());
+	}
+
+	_latencies.clear();
+	_gaps = _missing = 0;
+	_periodStart = now;
+	return summary;
+}
@@ -0,0 +1,39 @@
+#ifndef __TOPICSTATISTICS_H__
+#define __TOPICSTATISTICS_H__
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/date_time.hpp>
+#include <boost/thread/mutex.hpp>
+#include "GPSLib_Export.h"
+
+namespace GPSLib {
+	// one period of a topic's samples, as summarized by TopicStatistics::Take
+	class TopicSummary {
+	public:
+		unsigned long _samples;
+		unsigned long _gaps, _missing;  // jumps in a sensor's sequence numbers, and the samples they skipped
+		double _rate;  // samples a second
+		double _latency50, _latency90, _latency99, _latencyMax;  // milliseconds, 0 without samples
+	};
+
+	// The latency of each sample received on a topic, from the publisher's source timestamp to its arrival, and the
+	// gaps in each sensor's sample numbers, summarized once a period.  Samples may be added from any thread.
+	class GPSLib_Export TopicStatistics : private boost::noncopyable {
+		boost::mutex _statisticsMutex;
+		std::vector<double> _latencies;  // of the period, reused from period to period
+		std::map<std::string, unsigned long> _lastSequence;  // by sensor
+		unsigned long _gaps, _missing;
+		boost::posix_time::ptime _periodStart;
+	public:
+		TopicStatistics();
+
+		// latency in milliseconds - sequence 0 is a sample that isn't numbered, and isn't checked for gaps
+		void Add(const std::string &sensorID, unsigned long sequence, double latency);
+
+		// the period up to now, and start the next one
+		TopicSummary Take();
+	};
+}
+#endif
@@ -0,0 +1,122 @@
+#include "TrackStore.h"
+#include <algorithm>
+
+GPSLib::TrackStore::Track::Track(size_t capacity) : _times(capacity), _latitudes(capacity), _longitudes(capacity),
+	_altitudes(capacity), _speeds(capacity), _courses(capacity), _rejected(0) {}
+
+GPSLib::TrackPoint GPSLib::TrackStore::Track::Get(size_t i) const {
+	return TrackPoint(_times[i], _latitudes[i], _longitudes[i], _altitudes[i], _speeds[i], _courses[i]);
+}
+
+void GPSLib::TrackStore::Track::PopFront() {
+	_times.pop_front();
+	_latitudes.pop_front();
+	_longitudes.pop_front();
+	_altitudes.pop_front();
+	_speeds.pop_front();
+	_courses.pop_front();
+}
+
+GPSLib::TrackStore::TrackStore(boost::posix_time::time_duration window, size_t capacity) : _window(window), _capacity(capacity) {}
+
+boost::shared_ptr<GPSLib::TrackStore::Track> GPSLib::TrackStore::Find(const std::string &sensorID) const {
+	boost::shared_lock<boost::shared_mutex> lock(_tracksMutex);
+	const Tracks::const_iterator it = _tracks.find(sensorID);
+	return (it == _tracks.end()) ? boost::shared_ptr<Track>() : it->second;
+}
+
+bool GPSLib::TrackStore::Add(const std::string &sensorID, const TrackPoint &point) {
+	boost::shared_ptr<Track> track = Find(sensorID);
+	if (!track) {
+		boost::unique_lock<boost::shared_mutex> lock(_tracksMutex);
+		boost::shared_ptr<Track> &added = _tracks[sensorID];
+		if (!added)  // unless another thread added it first
+			added.reset(new Track(_capacity));
+		track = added;
+	}
+
+	boost::unique_lock<boost::shared_mutex> lock(track->_mutex);
+	if (!track->_times.empty() && (point._time <= track->_times.back())) {
+		track->_rejected++;
+		return false;
+	}
+
+	const boost::posix_time::ptime oldest = point._time - _window;
+	while (!track->_times.empty() && (track->_times.front() < oldest))
+		track->PopFront();
+
+	// a full ring overwrites its oldest
+	track->_times.push_back(point._time);
+	track->_latitudes.push_back(point._latitude);
+	track->_longitudes.push_back(point._longitude);
+	track->_altitudes.push_back(point._altitude);
+	track->_speeds.push_back(point._speed);
+	track->_courses.push_back(point._course);
+	return true;
+}
+
+bool GPSLib::TrackStore::GetLatest(const std::string &sensorID, TrackPoint &point) const {
+	const boost::shared_ptr<Track> track = Find(sensorID);
+	if (!track)
+		return false;
+
+	boost::shared_lock<boost::shared_mutex> lock(track->_mutex);
+	if (track->_times.empty())
+		return false;
+	point = track->Get(track->_times.size() - 1);
+	return true;
+}
+
+void GPSLib::TrackStore::GetRange(const std::string &sensorID, boost::posix_time::ptime from, boost::posix_time::ptime to,
+	std::vector<TrackPoint> &points) const {
+	const boost::shared_ptr<Track> track = Find(sensorID);
+	if (!track)
+		return;
+
+	boost::shared_lock<boost::shared_mutex> lock(track->_mutex);
+	const size_t first = std::lower_bound(track->_times.begin(), track->_times.end(), from) - track->_times.begin();
+	const size_t last = std::lower_bound(track->_times.begin() + first, track->_times.end(), to) - track->_times.begin();
+	points.reserve(points.size() + last - first);
+	for (size_t i = first; i < last; i++)
+		points.push_back(track->Get(i));
+}
+
+void GPSLib::TrackStore::GetTrack(const std::string &sensorID, std::vector<TrackPoint> &points) const {
+	const boost::shared_ptr<Track> track = Find(sensorID);
+	if (!track)
+		return;
+
+	boost::shared_lock<boost::shared_mutex> lock(track->_mutex);
+	points.reserve(points.size() + track->_times.size());
+	for (size_t i = 0; i < track->_times.size(); i++)
+		points.push_back(track->Get(i));
+}
+
+std::vector<std::string> GPSLib::TrackStore::GetSensors() const {
+	boost::shared_lock<boost::shared_mutex> lock(_tracksMutex);
+	std::vector<std::string> sensors;
+	sensors.reserve(_tracks.size());
+	for (Tracks::const_iterator it = _tracks.begin(); it != _tracks.end(); ++it)
+		sensors.push_back(it->first);
+	return sensors;
+}
+
+size_t GPSLib::TrackStore::GetSampleCount() const {
+	boost::shared_lock<boost::shared_mutex> lock(_tracksMutex);
+	size_t count = 0;
+	for (Tracks::const_iterator it = _tracks.begin(); it != _tracks.end(); ++it) {
+		boost::shared_lock<boost::shared_mutex> trackLock(it->second->_mutex);
+		count += it->second->_times.size();
+	}
+	return count;
+}
+
+unsigned long GPSLib::TrackStore::GetRejected() const {
+	boost::shared_lock<boost::shared_mutex> lock(_tracksMutex);
+	unsigned long rejected = 0;
+	for (Tracks::const_iterator it = _tracks.begin(); it != _tracks.end(); ++it) {
+		boost::shared_lock<boost::shared_mutex> trackLock(it->second->_mutex);
+		rejected += it->second->_rejected;
+	}
+	return rejected;
+}
@@ -0,0 +1,71 @@
+#ifndef __TRACKSTORE_H__
+#define __TRACKSTORE_H__
+
+#include <string>
+#include <vector>
+#include <boost/date_time.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/circular_buffer.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include "GPSLib_Export.h"
+
+namespace GPSLib {
+	// one sample of a sensor's track, as kept by TrackStore
+	class TrackPoint {
+	public:
+		boost::posix_time::ptime _time;
+		double _latitude, _longitude, _altitude;
+		double _speed, _course;  // knots, degrees
+
+		TrackPoint() : _latitude(0), _longitude(0), _altitude(0), _speed(0), _course(0) {}
+		TrackPoint(boost::posix_time::ptime time, double latitude, double longitude, double altitude, double speed, double course) :
+			_time(time), _latitude(latitude), _longitude(longitude), _altitude(altitude), _speed(speed), _course(course) {}
+	};
+
+	// The recent track of each sensor, held in memory for lookups by time.  A sensor's samples are kept in columns -
+	// one ring each of times, latitudes, longitudes and so on - in time order, so a range is found by binary search
+	// of the times alone.  A sample is kept until it is more than window older than the sensor's latest, or until
+	// its ring, of at most capacity samples, is full - ring memory is only taken as a sensor's track grows.  Samples
+	// may be added and queried from any threads - queries share a sensor's lock, so only wait on an Add to the same
+	// sensor, and never on each other.
+	class GPSLib_Export TrackStore : private boost::noncopyable {
+		class Track {
+		public:
+			mutable boost::shared_mutex _mutex;
+			boost::circular_buffer_space_optimized<boost::posix_time::ptime> _times;
+			boost::circular_buffer_space_optimized<double> _latitudes, _longitudes, _altitudes, _speeds, _courses;
+			unsigned long _rejected;  // samples no newer than the latest
+
+			explicit Track(size_t capacity);
+			TrackPoint Get(size_t i) const;
+			void PopFront();
+		};
+
+		typedef boost::unordered_map<std::string, boost::shared_ptr<Track> > Tracks;
+		const boost::posix_time::time_duration _window;
+		const size_t _capacity;
+		mutable boost::shared_mutex _tracksMutex;
+		Tracks _tracks;
+
+		boost::shared_ptr<Track> Find(const std::string &sensorID) const;
+	public:
+		TrackStore(boost::posix_time::time_duration window = boost::posix_time::minutes(10), size_t capacity = 6000);
+
+		// false, and the sample not kept, if it is no newer than the sensor's latest
+		bool Add(const std::string &sensorID, const TrackPoint &point);
+
+		// false if the sensor has no samples
+		bool GetLatest(const std::string &sensorID, TrackPoint &point) const;
+		// the samples from from up to but not including to, oldest first, appended to points
+		void GetRange(const std::string &sensorID, boost::posix_time::ptime from, boost::posix_time::ptime to,
+			std::vector<TrackPoint> &points) const;
+		// every sample held, oldest first, appended to points
+		void GetTrack(const std::string &sensorID, std::vector<TrackPoint> &points) const;
+
+		std::vector<std::string> GetSensors() const;
+		size_t GetSampleCount() const;  // of every sensor
+		unsigned long GetRejected() const;
+	};
+}
+#endif
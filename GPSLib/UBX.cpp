@@ -0,0 +1,110 @@
+#include "UBX.h"
+#include <boost/date_time/gregorian/gregorian.hpp>
+
+namespace {
+	// little-endian fields of a payload
+	unsigned int U1(const unsigned char *p) { return p[0]; }
+	unsigned int U2(const unsigned char *p) { return p[0] | (p[1] << 8); }
+	unsigned int U4(const unsigned char *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<unsigned int>(p[3]) << 24); }
+	int I1(const unsigned char *p) { return static_cast<signed char>(p[0]); }
+	int I2(const unsigned char *p) { return static_cast<short>(U2(p)); }
+	int I4(const unsigned char *p) { return static_cast<int>(U4(p)); }
+
+	const size_t NavPVTLength = 92, NavDOPLength = 18, NavSatHeaderLength = 8, NavSatEntryLength = 12;
+	enum { GNSS_GPS = 0, GNSS_SBAS = 1, GNSS_GLONASS = 6 };
+}
+
+std::vector<unsigned char> GPSLib::MakeUBXFrame(unsigned char messageClass, unsigned char messageId, const std::vector<unsigned char> &payload) {
+	std::vector<unsigned char> frame;
+	frame.reserve(UBXFramer::HeaderLength + payload.size() + UBXFramer::ChecksumLength);
+	frame.push_back(UBXFramer::Sync1);
+	frame.push_back(UBXFramer::Sync2);
+	frame.push_back(messageClass);
+	frame.push_back(messageId);
+	frame.push_back(payload.size() & 0xFF);
+	frame.push_back((payload.size() >> 8) & 0xFF);
+	frame.insert(frame.end(), payload.begin(), payload.end());
+	unsigned char a, b;
+	UBXChecksum(&frame[2], &frame[0] + frame.size(), a, b);
+	frame.push_back(a);
+	frame.push_back(b);
+	return frame;
+}
+
+bool GPSLib::DecodeNavPVT(const unsigned char *p, size_t length, UBXNavPVT &pvt) {
+	if (length < NavPVTLength)
+		return false;
+	pvt._year = U2(p+4);
+	pvt._month = U1(p+6);
+	pvt._day = U1(p+7);
+	pvt._hour = U1(p+8);
+	pvt._minute = U1(p+9);
+	pvt._second = U1(p+10);
+	pvt._valid = U1(p+11);
+	pvt._nano = I4(p+16);
+	pvt._fixType = U1(p+20);
+	pvt._flags = U1(p+21);
+	pvt._numSatellites = U1(p+23);
+	pvt._longitude = I4(p+24) * 1e-7;
+	pvt._latitude = I4(p+28) * 1e-7;
+	pvt._height = I4(p+32) / 1000.0;
+	pvt._heightMSL = I4(p+36) / 1000.0;
+	pvt._groundSpeed = I4(p+60) / 1000.0;
+	pvt._heading = I4(p+64) * 1e-5;
+	pvt._pdop = U2(p+76) * 0.01;
+
+	// a receiver without a date yet may send zeros, so only check when it says the date is valid
+	if ((pvt._valid & 1) && ((pvt._year < 1400) || (pvt._year > 9999) || (pvt._month < 1) || (pvt._month > 12) || (pvt._day < 1) ||
+		(pvt._day > boost::gregorian::gregorian_calendar::end_of_month_day(pvt._year, pvt._month))))
+		return false;
+	// the fraction may be negative when the solution is just before the second - the time is kept to that second
+	if (pvt._nano < 0)
+		pvt._nano = 0;
+	return (pvt._hour < 24) && (pvt._minute < 60) && (pvt._second <= 60);  // 60 for a leap second
+}
+
+bool GPSLib::DecodeNavDOP(const unsigned char *p, size_t length, UBXNavDOP &dop) {
+	if (length < NavDOPLength)
+		return false;
+	dop._gdop = U2(p+4) * 0.01;
+	dop._pdop = U2(p+6) * 0.01;
+	dop._tdop = U2(p+8) * 0.01;
+	dop._vdop = U2(p+10) * 0.01;
+	dop._hdop = U2(p+12) * 0.01;
+	dop._ndop = U2(p+14) * 0.01;
+	dop._edop = U2(p+16) * 0.01;
+	return true;
+}
+
+bool GPSLib::DecodeNavSat(const unsigned char *p, size_t length, std::vector<UBXSatellite> &satellites) {
+	if (length < NavSatHeaderLength)
+		return false;
+	const size_t numSatellites = U1(p+5);
+	if (length < NavSatHeaderLength + numSatellites * NavSatEntryLength)
+		return false;
+
+	satellites.resize(numSatellites);
+	for (size_t i = 0; i < numSatellites; i++) {
+		const unsigned char *s = p + NavSatHeaderLength + i * NavSatEntryLength;
+		satellites[i]._gnssId = U1(s);
+		satellites[i]._svId = U1(s+1);
+		satellites[i]._cno = U1(s+2);
+		satellites[i]._elevation = I1(s+3);
+		satellites[i]._azimuth = I2(s+4);
+		satellites[i]._used = (U4(s+8) & 0x08) != 0;
+	}
+	return true;
+}
+
+int GPSLib::NMEASatelliteNumber(int gnssId, int svId) {
+	switch (gnssId) {
+	case GNSS_GPS:
+		return ((svId >= 1) && (svId <= 32)) ? svId : 0;
+	case GNSS_SBAS:
+		return ((svId >= 120) && (svId <= 151)) ? (svId - 87) : 0;
+	case GNSS_GLONASS:
+		return ((svId >= 1) && (svId <= 32)) ? (svId + 64) : 0;
+	default:
+		return 0;
+	}
+}
@@ -0,0 +1,118 @@
+#ifndef __UBX_H__
+#define __UBX_H__
+
+#include <vector>
+#include <cstddef>
+#include "GPSLib_Export.h"
+
+namespace GPSLib {
+	// u-blox UBX binary protocol - a frame is two sync chars, class, id, little-endian payload length, the payload,
+	// then a two byte Fletcher checksum over class through payload
+	enum UBXClass { UBX_NAV = 0x01, UBX_CFG = 0x06 };
+	enum UBXNavId { UBX_NAV_DOP = 0x04, UBX_NAV_PVT = 0x07, UBX_NAV_SAT = 0x35 };
+	enum UBXCfgId { UBX_CFG_MSG = 0x01 };
+
+	inline void UBXChecksum(const unsigned char *begin, const unsigned char *end, unsigned char &a, unsigned char &b) {
+		a = b = 0;
+		for (; begin != end; ++begin) {
+			a += *begin;
+			b += a;
+		}
+	}
+
+	// Frames UBX messages out of a byte stream into a fixed-size buffer.  Bytes are only given to it from a Sync1
+	// on, and it says if the byte following turns out not to be Sync2, so the caller can treat that byte as text.
+	class UBXFramer {
+	public:
+		enum { Sync1 = 0xB5, Sync2 = 0x62, HeaderLength = 6, ChecksumLength = 2, MaxPayloadLength = 1024 };  // NAV-SAT for 84 satellites fits
+		enum Result { Framing, Complete, Invalid, NotUBX };
+	private:
+		unsigned char _buffer[HeaderLength + MaxPayloadLength + ChecksumLength];
+		size_t _length;
+		bool _complete;
+	public:
+		UBXFramer() : _length(0), _complete(false) {}
+
+		// true if a frame has been started but not completed
+		bool IsFraming() const { return !_complete && (_length != 0); }
+
+		// add one byte - Complete if it completed a frame, which is then in GetFrame() until the next call
+		Result Add(unsigned char c) {
+			if (_complete) {
+				_complete = false;
+				_length = 0;
+			}
+
+			if ((_length == 0) && (c != Sync1))
+				return NotUBX;
+			if ((_length == 1) && (c != Sync2)) {
+				_length = 0;
+				return NotUBX;
+			}
+			_buffer[_length++] = c;
+			if (_length < HeaderLength)
+				return Framing;
+
+			const size_t payloadLength = GetPayloadLength();
+			if (payloadLength > MaxPayloadLength) {
+				_length = 0;
+				return Invalid;
+			}
+			if (_length < HeaderLength + payloadLength + ChecksumLength)
+				return Framing;
+
+			unsigned char a, b;
+			UBXChecksum(_buffer + 2, _buffer + HeaderLength + payloadLength, a, b);
+			if ((a != _buffer[_length-2]) || (b != _buffer[_length-1])) {
+				_length = 0;
+				return Invalid;
+			}
+			_complete = true;
+			return Complete;
+		}
+
+		const unsigned char *GetFrame() const { return _buffer; }
+		size_t GetLength() const { return _length; }
+		size_t GetPayloadLength() const { return _buffer[4] | (_buffer[5] << 8); }
+	};
+
+	// sync chars through checksum
+	GPSLib_Export std::vector<unsigned char> MakeUBXFrame(unsigned char messageClass, unsigned char messageId, const std::vector<unsigned char> &payload);
+
+	// NAV-PVT, navigation position velocity time solution
+	class UBXNavPVT {
+	public:
+		int _year, _month, _day, _hour, _minute, _second, _nano;
+		int _valid;  // bit 0 date valid, bit 1 time valid
+		int _fixType;  // 0 no fix, 1 dead reckoning, 2 2D, 3 3D, 4 GNSS and dead reckoning, 5 time only
+		int _flags;  // bit 0 gnssFixOK, bit 1 diffSoln
+		int _numSatellites;
+		double _longitude, _latitude;  // decimal degrees
+		double _height, _heightMSL;  // meters above ellipsoid and mean sea level
+		double _groundSpeed;  // meters per second
+		double _heading;  // degrees, of motion
+		double _pdop;
+	};
+	// false if payload is too short for the message, or its date and time are out of range
+	GPSLib_Export bool DecodeNavPVT(const unsigned char *payload, size_t length, UBXNavPVT &pvt);
+
+	// NAV-DOP, dilution of precision
+	class UBXNavDOP {
+	public:
+		double _gdop, _pdop, _tdop, _vdop, _hdop, _ndop, _edop;
+	};
+	GPSLib_Export bool DecodeNavDOP(const unsigned char *payload, size_t length, UBXNavDOP &dop);
+
+	// NAV-SAT, one entry per satellite
+	class UBXSatellite {
+	public:
+		int _gnssId, _svId, _cno, _elevation, _azimuth;
+		bool _used;  // in the navigation solution
+	};
+	GPSLib_Export bool DecodeNavSat(const unsigned char *payload, size_t length, std::vector<UBXSatellite> &satellites);
+
+	// the satellite number NMEA uses for a UBX gnssId and svId - GPS 1-32, SBAS 33-64, GLONASS 65-96, 0 for systems
+	// without a number in that range
+	GPSLib_Export int NMEASatelliteNumber(int gnssId, int svId);
+}
+#endif
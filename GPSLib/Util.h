@@ -23,6 +23,17 @@ namespace GPSLib {
 	}
 
 
+	// days from 1970-01-01 to a date in the proleptic Gregorian calendar, without going through boost::gregorian
+	// http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+	inline int DaysSinceEpoch(int year, int month, int day) {
+		year -= (month <= 2) ? 1 : 0;
+		const int era = ((year >= 0) ? year : (year - 399)) / 400;
+		const int yearOfEra = year - era * 400;  // [0, 399]
+		const int dayOfYear = (153 * (month + ((month > 2) ? -3 : 9)) + 2) / 5 + day - 1;  // [0, 365], from March 1
+		const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;  // [0, 146096]
+		return era * 146097 + dayOfEra - 719468;
+	}
+
 	// http://en.wikipedia.org/wiki/Geographic_coordinate_conversion
 	inline double ToDecimalDegree(double degrees, double minutes, double seconds, const std::string &hemisphere) {
 		degrees+= minutes/60.0 + seconds/3600.0;
@@ -34,6 +45,13 @@ namespace GPSLib {
 		return ToDecimalDegree(degrees, minutes, 0.0, hemisphere);
 	}
 
+	// for a hemisphere already in hand as a character, without building a string to compare
+	inline double ToDecimalDegree(double degrees, double minutes, char hemisphere) {
+		degrees+= minutes/60.0;
+		if ((hemisphere == 'S') || (hemisphere == 'W')) degrees = -degrees;
+		return degrees;
+	}
+
 	inline void ToDegreesMinutesSeconds(double decimalDegrees, int &degrees, int &minutes, int &seconds) {
 		double intDegrees, fracDegrees;
 		fracDegrees=modf(decimalDegrees, &intDegrees);
@@ -2,12 +2,24 @@
 #include "../GPSDDSLib/GPSC.h"
 #include "../GPSDDSLib/GPSTypeSupportImpl.h"
 #include "../GPSDDSLib/DDSException.h"
+#include "../GPSDDSLib/QosProfiles.h"
 #include <dds/DCPS/Marked_Default_Qos.h>
 #include <dds/DCPS/Service_Participant.h>
 
 #include "../ASIOLib/Executor.h"
 #include "../ASIOLib/SerialPort.h"
+#include "../ASIOLib/BoundedQueue.h"
 #include "../GPSLib/GPSSentenceDecoder.h"
+#include "../GPSLib/GSVAggregator.h"
+#include "../GPSLib/EpochFixAssembler.h"
+#include "../GPSLib/UBX.h"
+#include "../GPSLib/FixedPoint.h"
+#include "../GPSLib/Geodesy.h"
+#include "../GPSLib/Conflator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
 #include <boost/program_options.hpp>
 #include <boost/thread.hpp>
 
@@ -18,62 +30,365 @@ void Log(const std::string &msg) {
 	std::cout << "[" << boost::this_thread::get_id() << "] " << msg << std::endl;
 }
 
+// one writer per topic - position, altitude and course go to either the double or the fixed point (compact) topics,
+// and the writers of the other are nil, as are those of the per-field topics when only the merged fix is published,
+// and that of the fix unless it was asked for
+class Writers {
+public:
+	GPS::FixDataDataWriter_var _fix;
+	GPS::PositionDataDataWriter_var _position;
+	GPS::AltitudeDataDataWriter_var _altitude;
+	GPS::CourseDataDataWriter_var _course;
+	GPS::CompactPositionDataDataWriter_var _compactPosition;
+	GPS::CompactAltitudeDataDataWriter_var _compactAltitude;
+	GPS::CompactCourseDataDataWriter_var _compactCourse;
+	GPS::SatelliteInfoDataDataWriter_var _satelliteInfo;
+	GPS::ActiveSatellitesDataDataWriter_var _activeSatellites;
+};
+
+// how often, and on how much change, each topic is published
+class PublishPolicies {
+public:
+	GPSLib::PublishPolicy _position;  // deadband in meters moved, also for the fix
+	GPSLib::PublishPolicy _altitude;  // meters
+	GPSLib::PublishPolicy _course;  // degrees of course
+	double _speedDeadband;  // knots, a change of which republishes the course whatever its deadband
+	GPSLib::PublishPolicy _activeSatellites;  // largest change of PDOP, HDOP or VDOP
+	GPSLib::PublishPolicy _satelliteInfo;  // no deadband
+	GPSLib::PublishPolicy _fix;
+};
+
+// the values of each topic as held between flushes, before they are copied into a sample - each with the time the
+// serial read that completed it finished, the source timestamp of the sample
+class PositionValue {
+public:
+	boost::posix_time::ptime _read;
+	boost::int64_t _date;
+	GPSLib::FixedCoordinate _latitude, _longitude;
+};
+
+class AltitudeValue {
+public:
+	boost::posix_time::ptime _read;
+	boost::int64_t _date;
+	boost::int32_t _altitude;  // millimeters
+};
+
+class CourseValue {
+public:
+	boost::posix_time::ptime _read;
+	boost::int64_t _date;
+	double _speed, _course;  // knots, degrees - only scaled for the compact topic, so GPS_Course keeps the sentence's precision
+};
+
+class ActiveSatellitesValue {
+public:
+	boost::posix_time::ptime _read;
+	std::vector<int> _satellitesInView;
+	double _pdop, _hdop, _vdop;
+};
+
+class SatelliteInfoValue {
+public:
+	boost::posix_time::ptime _read;
+	std::vector<GPSLib::SatelliteInfo> _satelliteInfo;
+};
+
+class FixValue {
+public:
+	boost::posix_time::ptime _read;
+	boost::int64_t _date;
+	GPSLib::EpochFix _fix;
+};
+
+// the number a sample is written with - the compact types carry none
+template <typename TSample>
+void SetSequence(TSample &sample, CORBA::ULong sequence) { sample.sequence = sequence; }
+void SetSequence(GPS::CompactPositionData &, CORBA::ULong) {}
+void SetSequence(GPS::CompactAltitudeData &, CORBA::ULong) {}
+void SetSequence(GPS::CompactCourseData &, CORBA::ULong) {}
+
+// A writer's sample, reused from write to write, with its instance registered once so a write neither allocates nor
+// hashes the key.  Written from the publishing stage's threads, which hold _mutex while they fill in and write it.
+template <typename TSample, typename TDataWriter>
+class Instance {
+	TAO_Objref_Var_T<TDataWriter> _writer;
+	DDS::InstanceHandle_t _handle;
+	bool _numbered;
+	CORBA::ULong _sequence;
+public:
+	boost::mutex _mutex;
+	TSample _sample;
+
+	Instance() : _handle(DDS::HANDLE_NIL), _numbered(false), _sequence(0) {}
+
+	// nothing is registered or written for a nil writer, of a topic that isn't being published - numbered samples
+	// carry a sequence number one higher than the last written, for the subscriber to find gaps with
+	void Register(TDataWriter *writer, const std::string &sensorID, bool numbered) {
+		_writer = TDataWriter::_duplicate(writer);
+		_numbered = numbered;
+		_sample.sensor_id = sensorID.c_str();
+		SetSequence(_sample, 0);
+		if (!CORBA::is_nil(writer) && ((_handle = writer->register_instance(_sample)) == DDS::HANDLE_NIL))
+			throw DDSException("register_instance() failed");
+	}
+
+	bool IsPublished() const { return !CORBA::is_nil(_writer.in()); }
+
+	// stamped with the time the serial read finished, so the subscriber can measure the latency from the port
+	void Write(const char *error, const boost::posix_time::ptime &read) {
+		if (CORBA::is_nil(_writer.in()))
+			return;
+		static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+		const boost::posix_time::time_duration sinceEpoch = read - epoch;
+		DDS::Time_t timestamp;
+		timestamp.sec = static_cast<CORBA::Long>(sinceEpoch.total_seconds());
+		timestamp.nanosec = static_cast<CORBA::ULong>(sinceEpoch.fractional_seconds() * (1000000000 / boost::posix_time::time_duration::ticks_per_second()));
+		if (_numbered)
+			SetSequence(_sample, ++_sequence);
+		if (_writer->write_w_timestamp(_sample, _handle, timestamp) != DDS::RETCODE_OK)
+			throw DDSException(error);
+	}
+};
+
+// DDS writes, queued from the decoder's handlers and made on threads of their own, so a write that blocks - reliable
+// QoS with a full history, say - holds up neither decoding nor the serial reads behind it.  With more than one
+// thread, writes of the same topic may be made out of order.
+class PublishingStage : private boost::noncopyable {
+	ASIOLib::BoundedQueue<boost::function<void ()> > _queue;
+	boost::thread_group _writerThreads;
+	boost::asio::deadline_timer _statsTimer;
+	boost::posix_time::time_duration _statsInterval;
+
+	void WriterThread() {
+		boost::function<void ()> write;
+		while (_queue.Pop(write)) {
+			try {
+				write();
+			} catch (const std::exception &e) {
+				Log(std::string("GPSPublisher exception (write): ") + e.what());
+			} catch (const CORBA::Exception &e) {
+				Log(std::string("GPSPublisher exception (write): ") + e._name());
+			}
+		}
+	}
+
+	void ReportStats(const boost::system::error_code &ec) {
+		if (ec == boost::asio::error::operation_aborted)
+			return;
+		std::ostringstream os;
+		os << "publish queue depth " << _queue.GetDepth() << "/" << _queue.GetCapacity() << ", high water " << _queue.GetHighWater() <<
+			", dropped " << _queue.GetDropped();
+		Log(os.str());
+		_statsTimer.expires_at(_statsTimer.expires_at() + _statsInterval);
+		_statsTimer.async_wait(boost::bind(&PublishingStage::ReportStats, this, boost::asio::placeholders::error));
+	}
+public:
+	PublishingStage(boost::asio::io_service &ios, size_t capacity, ASIOLib::FullQueuePolicy policy, unsigned int numThreads) :
+	  _queue(capacity, policy), _statsTimer(ios) {
+		for (unsigned int i = 0; i < std::max(numThreads, 1u); i++)
+			_writerThreads.create_thread(boost::bind(&PublishingStage::WriterThread, this));
+	}
+
+	// false if the write was dropped because the queue is full
+	bool Push(const boost::function<void ()> &write) { return _queue.Push(write); }
+
+	// log the queue depth every interval, from the executor
+	void ReportStatsEvery(boost::posix_time::time_duration interval) {
+		_statsInterval = interval;
+		_statsTimer.expires_from_now(interval);
+		_statsTimer.async_wait(boost::bind(&PublishingStage::ReportStats, this, boost::asio::placeholders::error));
+	}
+
+	~PublishingStage() { Stop(); }
+
+	// makes the writes still queued, then ends the writer threads
+	void Stop() {
+		boost::system::error_code ec;
+		_statsTimer.cancel(ec);
+		_queue.Stop();
+		_writerThreads.join_all();
+	}
+};
+
 class GPSPublisher : public boost::enable_shared_from_this<GPSPublisher> {
 	boost::shared_ptr<ASIOLib::SerialPort> _serialPort;
 	const std::string _portName;
 	const unsigned int _baudRate;
+	const bool _ubx;  // receiver is switched to binary UBX output
 	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> _decoder;  // so shared_from_this() will work  
-	const GPS::PositionDataDataWriter_var _positionWriter;
-	const GPS::AltitudeDataDataWriter_var _altitudeWriter;
-	const GPS::CourseDataDataWriter_var _courseWriter;
-	const GPS::SatelliteInfoDataDataWriter_var _satelliteInfoWriter;
-	const GPS::ActiveSatellitesDataDataWriter_var _activeSatellitesWriter;
-	const boost::posix_time::ptime _epoch;
-
-	std::string GetSensorID() {
+	GPSLib::GSVAggregator _gsvAggregator;  // fed from the decoder's handlers, which run one at a time, so needs no locking
+	const bool _compact;  // publishing to the compact topics
+	const bool _fixOnly;  // publishing the merged fix, and not the per-field topics it replaces
+	boost::shared_ptr<GPSLib::EpochFixAssembler> _fixAssembler;  // 0 unless the merged fix is published
+	const std::string _sensorID;
+	boost::posix_time::ptime _readTime;  // when the read being decoded finished
+	Instance<GPS::FixData, GPS::FixDataDataWriter> _fix;
+	Instance<GPS::PositionData, GPS::PositionDataDataWriter> _position;
+	Instance<GPS::AltitudeData, GPS::AltitudeDataDataWriter> _altitude;
+	Instance<GPS::CourseData, GPS::CourseDataDataWriter> _course;
+	Instance<GPS::CompactPositionData, GPS::CompactPositionDataDataWriter> _compactPosition;
+	Instance<GPS::CompactAltitudeData, GPS::CompactAltitudeDataDataWriter> _compactAltitude;
+	Instance<GPS::CompactCourseData, GPS::CompactCourseDataDataWriter> _compactCourse;
+	Instance<GPS::SatelliteInfoData, GPS::SatelliteInfoDataDataWriter> _satelliteInfo;
+	Instance<GPS::ActiveSatellitesData, GPS::ActiveSatellitesDataDataWriter> _activeSatellites;
+	// keyed on the sensor ID, each publishes to the Instance(s) of its topic
+	const PublishPolicies _policies;
+	PublishingStage &_stage;
+	boost::shared_ptr<GPSLib::Conflator<std::string, PositionValue> > _positionConflator;
+	boost::shared_ptr<GPSLib::Conflator<std::string, AltitudeValue> > _altitudeConflator;
+	boost::shared_ptr<GPSLib::Conflator<std::string, CourseValue> > _courseConflator;
+	boost::shared_ptr<GPSLib::Conflator<std::string, ActiveSatellitesValue> > _activeSatellitesConflator;
+	boost::shared_ptr<GPSLib::Conflator<std::string, SatelliteInfoValue> > _satelliteInfoConflator;
+	boost::shared_ptr<GPSLib::Conflator<std::string, FixValue> > _fixConflator;
+
+	static std::string GetSensorID(const std::string &portName) {
 		// use machine name/port name as sensor ID
 		boost::system::error_code ec;
 		std::string hostName = boost::asio::ip::host_name(ec);
 		if (ec)
 			hostName = "<UNKNOWN>";
-		return hostName + ":" + _portName;
+		return hostName + ":" + portName;
 	}
 
-	void PublishPosition(boost::posix_time::ptime date, double latitude, double longitude) {
-		GPS::PositionData sample;
-		sample.sensor_id = GetSensorID().c_str();
-		sample.date = (date-_epoch).total_milliseconds();
-		sample.latitude = latitude;
-		sample.longitude = longitude;
+	// dates are UTC milliseconds since 1970 - values arrive in fixed point, as read from the sentence, and are only
+	// converted to double for the double topics.  Each goes through the conflator of its topic, which calls the
+	// matching Write* now or on its next flush, if it is to be published at all.
+	void PublishPosition(boost::int64_t date, GPSLib::FixedCoordinate latitude, GPSLib::FixedCoordinate longitude) {
+		PositionValue value;
+		value._read = _readTime;
+		value._date = date;
+		value._latitude = latitude;
+		value._longitude = longitude;
+		_positionConflator->Add(_sensorID, value);
+	}
 
-		if (_positionWriter->write(sample, DDS::HANDLE_NIL) != DDS::RETCODE_OK)
-			throw DDSException("position write() failed");
+	void PublishAltitude(boost::int64_t date, boost::int32_t altitude) {  // millimeters
+		AltitudeValue value;
+		value._read = _readTime;
+		value._date = date;
+		value._altitude = altitude;
+		_altitudeConflator->Add(_sensorID, value);
 	}
 
-	void PublishAltitude(boost::posix_time::ptime date, double altitude) {
-		GPS::AltitudeData sample;
-		sample.sensor_id = GetSensorID().c_str();
-		sample.date = (date-_epoch).total_milliseconds();
-		sample.altitude = altitude;
+	void PublishCourse(boost::int64_t date, double speed, double course) {  // knots, degrees
+		CourseValue value;
+		value._read = _readTime;
+		value._date = date;
+		value._speed = speed;
+		value._course = course;
+		_courseConflator->Add(_sensorID, value);
+	}
 
-		if (_altitudeWriter->write(sample, DDS::HANDLE_NIL) != DDS::RETCODE_OK)
-			throw DDSException("altitude write() failed");
+	void PublishFix(const GPSLib::EpochFix &fix) {
+		FixValue value;
+		if (!fix._valid || !_decoder->GetUTCMilliseconds(static_cast<int>(fix._time.total_milliseconds()), value._date))
+			return;  // only post if valid
+		value._read = fix._received;  // the read that completed the fix, not the one being decoded now
+		value._fix = fix;
+		_fixConflator->Add(_sensorID, value);
 	}
 
-	void PublishCourse(boost::posix_time::ptime date, double speed, double course) {
-		GPS::CourseData sample;
-		sample.sensor_id = GetSensorID().c_str();
-		sample.date = (date-_epoch).total_milliseconds();
-		sample.speed = speed;
-		sample.course = course;
+	void PublishSatelliteInfo(const std::vector<GPSLib::SatelliteInfo> &satelliteInfo) {
+		SatelliteInfoValue value;
+		value._read = _readTime;
+		value._satelliteInfo = satelliteInfo;
+		_satelliteInfoConflator->Add(_sensorID, value);
+	}
 
-		if (_courseWriter->write(sample, DDS::HANDLE_NIL) != DDS::RETCODE_OK)
-			throw DDSException("course write() failed");
+	void PublishActiveSatellites(const std::vector<int> &satellitesInView, double pdop, double hdop, double vdop) {
+		ActiveSatellitesValue value;
+		value._read = _readTime;
+		value._satellitesInView = satellitesInView;
+		value._pdop = pdop;
+		value._hdop = hdop;
+		value._vdop = vdop;
+		_activeSatellitesConflator->Add(_sensorID, value);
 	}
 
-	void PublishSatelliteInfo(const std::vector<GPSLib::SatelliteInfo> &satelliteInfo) {
-		GPS::SatelliteInfoData sample;
-		sample.sensor_id = GetSensorID().c_str();
+	// called by the conflators - the write itself is made by the publishing stage
+	template <typename TValue>
+	void Enqueue(void (GPSPublisher::*write)(const std::string &, const TValue &), const std::string &sensorID, const TValue &value) {
+		_stage.Push(boost::bind(write, this, sensorID, value));
+	}
+
+	void WritePosition(const std::string &/*sensorID*/, const PositionValue &value) {
+		if (_compact) {
+			boost::mutex::scoped_lock lock(_compactPosition._mutex);
+			_compactPosition._sample.date = value._date;
+			_compactPosition._sample.latitude = value._latitude.GetValue();
+			_compactPosition._sample.longitude = value._longitude.GetValue();
+			_compactPosition.Write("compact position write() failed", value._read);
+			return;
+		}
+
+		boost::mutex::scoped_lock lock(_position._mutex);
+		_position._sample.date = value._date;
+		_position._sample.latitude = value._latitude.GetDegrees();
+		_position._sample.longitude = value._longitude.GetDegrees();
+		_position.Write("position write() failed", value._read);
+	}
+
+	void WriteAltitude(const std::string &/*sensorID*/, const AltitudeValue &value) {
+		if (_compact) {
+			boost::mutex::scoped_lock lock(_compactAltitude._mutex);
+			_compactAltitude._sample.date = value._date;
+			_compactAltitude._sample.altitude = value._altitude;
+			_compactAltitude.Write("compact altitude write() failed", value._read);
+			return;
+		}
+
+		boost::mutex::scoped_lock lock(_altitude._mutex);
+		_altitude._sample.date = value._date;
+		_altitude._sample.altitude = value._altitude / 1000.0;
+		_altitude.Write("altitude write() failed", value._read);
+	}
+
+	void WriteCourse(const std::string &/*sensorID*/, const CourseValue &value) {
+		if (_compact) {
+			boost::mutex::scoped_lock lock(_compactCourse._mutex);
+			_compactCourse._sample.date = value._date;
+			_compactCourse._sample.speed = GPSLib::ToScaled(value._speed, 3);
+			_compactCourse._sample.course = GPSLib::ToScaled(value._course, 2);
+			_compactCourse.Write("compact course write() failed", value._read);
+			return;
+		}
+
+		boost::mutex::scoped_lock lock(_course._mutex);
+		_course._sample.date = value._date;
+		_course._sample.speed = value._speed;
+		_course._sample.course = value._course;
+		_course.Write("course write() failed", value._read);
+	}
+
+	void WriteFix(const std::string &/*sensorID*/, const FixValue &value) {
+		const GPSLib::EpochFix &fix = value._fix;
+		boost::mutex::scoped_lock lock(_fix._mutex);
+		GPS::FixData &sample = _fix._sample;
+		sample.date = value._date;
+		sample.received = (value._read - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_milliseconds();
+		sample.latitude = fix._latitude;
+		sample.longitude = fix._longitude;
+		sample.altitude = fix._altitude;
+		sample.speed = fix._speed;
+		sample.course = fix._course;
+		sample.pdop = fix._pdop;
+		sample.hdop = fix._hdop;
+		sample.vdop = fix._vdop;
+		sample.quality = fix._quality;
+		sample.fixMode = fix._fixMode;
+		sample.numSatellites = fix._numSatellites;
+		sample.activeSatellites.length(fix._activeSatellites.size());
+		for (size_t i = 0; i < fix._activeSatellites.size(); i++)
+			sample.activeSatellites[i] = fix._activeSatellites[i];
+		_fix.Write("fix write() failed", value._read);
+	}
+
+	void WriteSatelliteInfo(const std::string &/*sensorID*/, const SatelliteInfoValue &value) {
+		const std::vector<GPSLib::SatelliteInfo> &satelliteInfo = value._satelliteInfo;
+		// a sequence keeps its buffer when shortened, so only a larger sky view than any before allocates
+		boost::mutex::scoped_lock lock(_satelliteInfo._mutex);
+		GPS::SatelliteInfoData &sample = _satelliteInfo._sample;
 		sample.satelliteInfo.length(satelliteInfo.size());
 		for (size_t i=0; i<satelliteInfo.size(); i++) {
 			sample.satelliteInfo[i].prn = satelliteInfo[i]._prn;
@@ -81,68 +396,200 @@ class GPSPublisher : public boost::enable_shared_from_this<GPSPublisher> {
 			sample.satelliteInfo[i].elevation = satelliteInfo[i]._elevation;
 			sample.satelliteInfo[i].snr = satelliteInfo[i]._snr;
 		}
+		_satelliteInfo.Write("satelliteInfo write() failed", value._read);
+	}
 
-		if (_satelliteInfoWriter->write(sample, DDS::HANDLE_NIL) != DDS::RETCODE_OK)
-			throw DDSException("satelliteInfo write() failed");
+	void WriteActiveSatellites(const std::string &/*sensorID*/, const ActiveSatellitesValue &value) {
+		boost::mutex::scoped_lock lock(_activeSatellites._mutex);
+		GPS::ActiveSatellitesData &sample = _activeSatellites._sample;
+		sample.activeSatellites.length(value._satellitesInView.size());
+		for (size_t i=0; i<value._satellitesInView.size(); i++) 
+			sample.activeSatellites[i] = value._satellitesInView[i];
+		sample.pdop = value._pdop;
+		sample.hdop = value._hdop;
+		sample.vdop = value._vdop;
+		_activeSatellites.Write("activeSatellitesInfo write() failed", value._read);
 	}
 
-	void PublishActiveSatellites(const std::vector<int> &satellitesInView, double pdop, double hdop, double vdop) {
-		GPS::ActiveSatellitesData sample;
-		sample.sensor_id = GetSensorID().c_str();
-		sample.activeSatellites.length(satellitesInView.size());
-		for (size_t i=0; i<satellitesInView.size(); i++) 
-			sample.activeSatellites[i] = satellitesInView[i];
-		sample.pdop = pdop;
-		sample.hdop = hdop;
-		sample.vdop = vdop;
 
-		if (_activeSatellitesWriter->write(sample, DDS::HANDLE_NIL) != DDS::RETCODE_OK)
-			throw DDSException("activeSatellitesInfo write() failed");
+	// turn on NAV-DOP, NAV-PVT and NAV-SAT once per navigation solution, and turn off the NMEA sentences they replace
+	void SwitchToUBX() {
+		const unsigned char NMEAClass = 0xF0, GGA = 0x00, GLL = 0x01, GSA = 0x02, GSV = 0x03, RMC = 0x04, VTG = 0x05;
+		const unsigned char messages[][3] = {
+			{ GPSLib::UBX_NAV, GPSLib::UBX_NAV_DOP, 1 }, { GPSLib::UBX_NAV, GPSLib::UBX_NAV_PVT, 1 }, { GPSLib::UBX_NAV, GPSLib::UBX_NAV_SAT, 1 },
+			{ NMEAClass, GGA, 0 }, { NMEAClass, GLL, 0 }, { NMEAClass, GSA, 0 }, { NMEAClass, GSV, 0 }, { NMEAClass, RMC, 0 }, { NMEAClass, VTG, 0 }
+		};
+		for (size_t i = 0; i < sizeof(messages) / sizeof(messages[0]); i++)  // CFG-MSG with class, id and rate sets the rate on the port it arrives on
+			_serialPort->Write(GPSLib::MakeUBXFrame(GPSLib::UBX_CFG, GPSLib::UBX_CFG_MSG, std::vector<unsigned char>(messages[i], messages[i] + 3)));
 	}
 
+	// installed once, before the port is opened - times are put on the decoder's most recent date, so nothing is
+	// published until the first RMC
+	void CreateConflators(boost::asio::io_service &ios) {
+		_positionConflator.reset(new GPSLib::Conflator<std::string, PositionValue>(ios, _policies._position));
+		_positionConflator->Change = [](const PositionValue &published, const PositionValue &value) {
+			return GPSLib::HaversineDistance(published._latitude.GetDegrees(), published._longitude.GetDegrees(),
+				value._latitude.GetDegrees(), value._longitude.GetDegrees());
+		};
+		_positionConflator->OnPublish = boost::bind(&GPSPublisher::Enqueue<PositionValue>, this, &GPSPublisher::WritePosition, _1, _2);
 
-	void OnRead(boost::asio::io_service &ios, const std::vector<unsigned char> &buffer, size_t bytesRead) {
-		// GPS decode here
-		_decoder->OnGGA = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude, int quality, 
-			int /*numSatellites*/, double /*horizontalDilution*/, double altitude) {
-			if (quality != 0) { // only post if valid
-				PublishPosition(boost::posix_time::ptime(_epoch + time), latitude, longitude);
-				PublishAltitude(boost::posix_time::ptime(_epoch + time), altitude);
-			}
+		_altitudeConflator.reset(new GPSLib::Conflator<std::string, AltitudeValue>(ios, _policies._altitude));
+		_altitudeConflator->Change = [](const AltitudeValue &published, const AltitudeValue &value) {
+			return std::abs(value._altitude - published._altitude) / 1000.0;
 		};
-		_decoder->OnGLL = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude, const std::string &validity) {
-			if (validity == "A")  // only post if valid
-				PublishPosition(boost::posix_time::ptime(_epoch + time), latitude, longitude);
+		_altitudeConflator->OnPublish = boost::bind(&GPSPublisher::Enqueue<AltitudeValue>, this, &GPSPublisher::WriteAltitude, _1, _2);
+
+		_courseConflator.reset(new GPSLib::Conflator<std::string, CourseValue>(ios, _policies._course));
+		const double speedDeadband = _policies._speedDeadband, courseDeadband = _policies._course._deadband;
+		_courseConflator->Change = [speedDeadband, courseDeadband](const CourseValue &published, const CourseValue &value) {
+			// a change of speed of at least its own deadband counts as a change of course of at least the course's, so
+			// a vehicle stopping, or setting off again on the same heading, is published
+			const double angle = GPSLib::AngleBetween(published._course, value._course);
+			const double speedChange = std::fabs(value._speed - published._speed);
+			return ((speedChange > 0) && (speedChange >= speedDeadband)) ? std::max(angle, courseDeadband) : angle;
 		};
-		_decoder->OnRMC = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude,
-			double speed, double course, boost::gregorian::date date, const std::string &validity) {
-			if (validity == "A") {  // only post if valid
-				PublishPosition(boost::posix_time::ptime(date, time), latitude, longitude);
-				PublishCourse(boost::posix_time::ptime(date, time), speed, course);
-			}
+		_courseConflator->OnPublish = boost::bind(&GPSPublisher::Enqueue<CourseValue>, this, &GPSPublisher::WriteCourse, _1, _2);
+
+		_activeSatellitesConflator.reset(new GPSLib::Conflator<std::string, ActiveSatellitesValue>(ios, _policies._activeSatellites));
+		_activeSatellitesConflator->Change = [](const ActiveSatellitesValue &published, const ActiveSatellitesValue &value) {
+			return std::max(std::fabs(value._pdop - published._pdop), std::max(std::fabs(value._hdop - published._hdop), std::fabs(value._vdop - published._vdop)));
 		};
-		_decoder->OnGSV = [&](boost::asio::io_service &ios, int /*totalMessages*/, int /*messageNumber*/, int /*totalSatellitesInView*/, const std::vector<GPSLib::SatelliteInfo> &satelliteInfo) {
+		_activeSatellitesConflator->OnPublish = boost::bind(&GPSPublisher::Enqueue<ActiveSatellitesValue>, this, &GPSPublisher::WriteActiveSatellites, _1, _2);
+
+		_satelliteInfoConflator.reset(new GPSLib::Conflator<std::string, SatelliteInfoValue>(ios, _policies._satelliteInfo));
+		_satelliteInfoConflator->OnPublish = boost::bind(&GPSPublisher::Enqueue<SatelliteInfoValue>, this, &GPSPublisher::WriteSatelliteInfo, _1, _2);
+
+		_fixConflator.reset(new GPSLib::Conflator<std::string, FixValue>(ios, _policies._fix));
+		_fixConflator->Change = [](const FixValue &published, const FixValue &value) {
+			return GPSLib::HaversineDistance(published._fix._latitude, published._fix._longitude, value._fix._latitude, value._fix._longitude);
+		};
+		_fixConflator->OnPublish = boost::bind(&GPSPublisher::Enqueue<FixValue>, this, &GPSPublisher::WriteFix, _1, _2);
+
+		_positionConflator->Start();
+		_altitudeConflator->Start();
+		_courseConflator->Start();
+		_activeSatellitesConflator->Start();
+		_satelliteInfoConflator->Start();
+		_fixConflator->Start();
+	}
+
+	void InstallHandlers(boost::asio::io_service &ios) {
+		// GGA, RMC and GSA are merged into one fix per epoch, published once all three have been seen or the next epoch
+		// starts - without a timeout, so every fix is published from the decoder's handlers like everything else.  The
+		// assembler takes fully decoded sentences, so is only fed when the fix is published - the per-field topics
+		// alone are read through the view, converting only the fields they need.
+		if (_fix.IsPublished()) {
+			_fixAssembler.reset(new GPSLib::EpochFixAssembler(ios, GPSLib::SM_GGA | GPSLib::SM_RMC | GPSLib::SM_GSA,
+				boost::posix_time::time_duration(boost::posix_time::not_a_date_time)));
+			_fixAssembler->Now = [&]() { return _readTime; };
+			_fixAssembler->OnFix = [&](boost::asio::io_service &ios, const GPSLib::EpochFix &fix) {
+				PublishFix(fix);
+			};
+		}
+
+		if (_ubx) {
+			// NAV-PVT arrives as GGA and RMC
+			_decoder->OnGGA = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude,
+				int quality, int numSatellites, double horizontalDilution, double altitude) {
+				if (_fixAssembler)
+					_fixAssembler->AddGGA(ios, time, latitude, longitude, quality, numSatellites, horizontalDilution, altitude);
+				boost::int64_t date;
+				if ((quality == 0) || !_decoder->GetUTCMilliseconds(static_cast<int>(time.total_milliseconds()), date))
+					return;  // only post if valid
+				PublishPosition(date, GPSLib::FixedCoordinate::FromDegrees(latitude), GPSLib::FixedCoordinate::FromDegrees(longitude));
+				PublishAltitude(date, GPSLib::ToScaled(altitude, 3));
+			};
+			_decoder->OnRMC = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude,
+				double speed, double course, boost::gregorian::date date, const std::string &validity) {
+				if (_fixAssembler)
+					_fixAssembler->AddRMC(ios, time, latitude, longitude, speed, course, date, validity);
+				boost::int64_t utc;
+				if ((validity == "A") && _decoder->GetUTCMilliseconds(static_cast<int>(time.total_milliseconds()), utc))  // only post if valid
+					PublishCourse(utc, speed, course);
+			};
+		} else if (_fixAssembler) {
+			_decoder->OnGGA = boost::bind(&GPSLib::EpochFixAssembler::AddGGA, _fixAssembler, _1, _2, _3, _4, _5, _6, _7, _8);
+			_decoder->OnRMC = boost::bind(&GPSLib::EpochFixAssembler::AddRMC, _fixAssembler, _1, _2, _3, _4, _5, _6, _7, _8);
+		}
+		if (!_ubx && !_fixOnly) {
+			// read through the view, so a sentence without a fix is dropped before any of its other fields are converted
+			_decoder->OnSentence = [&](boost::asio::io_service &ios, const GPSLib::SentenceView &view) {
+				boost::int64_t date;
+				GPSLib::FixedCoordinate latitude, longitude;
+				switch (view.GetType()) {
+				case GPSLib::SM_GGA: {
+					int quality;
+					if (!view.GetInt(GPSLib::GGAFields::Quality, quality) || (quality == 0))
+						return;  // only post if valid
+					boost::int32_t altitude = 0;
+					if (!_decoder->GetUTCMilliseconds(view, GPSLib::GGAFields::Time, date) || !view.GetLatLng(GPSLib::GGAFields::Latitude, latitude) ||
+						!view.GetLatLng(GPSLib::GGAFields::Longitude, longitude))
+						return;
+					view.GetScaled(GPSLib::GGAFields::Altitude, 3, altitude);
+					PublishPosition(date, latitude, longitude);
+					PublishAltitude(date, altitude);
+					break;
+				}
+				case GPSLib::SM_GLL:
+					if (view.Equals(GPSLib::GLLFields::Validity, "A") && _decoder->GetUTCMilliseconds(view, GPSLib::GLLFields::Time, date) &&
+						view.GetLatLng(GPSLib::GLLFields::Latitude, latitude) && view.GetLatLng(GPSLib::GLLFields::Longitude, longitude))  // only post if valid
+						PublishPosition(date, latitude, longitude);
+					break;
+				case GPSLib::SM_RMC:
+					if (view.Equals(GPSLib::RMCFields::Validity, "A") && _decoder->GetUTCMilliseconds(view, GPSLib::RMCFields::Time, date) &&
+						view.GetLatLng(GPSLib::RMCFields::Latitude, latitude) && view.GetLatLng(GPSLib::RMCFields::Longitude, longitude)) {  // only post if valid
+						double speed = 0, course = 0;
+						view.GetDouble(GPSLib::RMCFields::Speed, speed);
+						view.GetDouble(GPSLib::RMCFields::Course, course);
+						PublishPosition(date, latitude, longitude);
+						PublishCourse(date, speed, course);
+					}
+					break;
+				}
+			};
+		}
+		// publish one complete sky view per GSV sequence, rather than one partial view per fragment
+		_decoder->OnGSV = boost::bind(&GPSLib::GSVAggregator::Add, &_gsvAggregator, _1, _2, _3, _4, _5);
+		_gsvAggregator.OnSatellitesInView = [&](boost::asio::io_service &ios, int /*totalSatellitesInView*/, const std::vector<GPSLib::SatelliteInfo> &satelliteInfo) {
 			PublishSatelliteInfo(satelliteInfo);
 		};
 		_decoder->OnGSA = [&](boost::asio::io_service &ios, const std::string &mode, int fix, const std::vector<int> &satellitesInView, double pdop, double hdop, double vdop) {
+			if (_fixAssembler)
+				_fixAssembler->AddGSA(ios, mode, fix, satellitesInView, pdop, hdop, vdop);
 			PublishActiveSatellites(satellitesInView, pdop, hdop, vdop);
 		};
+	}
 
-
-		_decoder->AddBytes(ios, std::vector<unsigned char>(buffer.begin(), buffer.begin()+bytesRead));
+	// the decoder decodes inline, so every handler it calls from here sees the time of the read that completed its sentence
+	void OnRead(boost::asio::io_service &ios, const std::vector<unsigned char> &buffer, size_t bytesRead) {
+		_readTime = boost::posix_time::microsec_clock::universal_time();
+		_decoder->AddBytes(ios, buffer, bytesRead);
 	}
 
 public:
-	GPSPublisher(const std::string &portName, int baudRate, GPS::PositionDataDataWriter_ptr positionWriter, GPS::AltitudeDataDataWriter_ptr altitudeWriter,
-		GPS::CourseDataDataWriter_ptr courseWriter, GPS::SatelliteInfoDataDataWriter_ptr satelliteInfoWriter, GPS::ActiveSatellitesDataDataWriter_ptr activeSatellitesWriter) : 
-	_epoch(boost::gregorian::date(1970, 1, 1)),
-	  _portName(portName), _baudRate(baudRate), _positionWriter(positionWriter), _altitudeWriter(altitudeWriter),
-		  _courseWriter(courseWriter), _satelliteInfoWriter(satelliteInfoWriter), _activeSatellitesWriter(activeSatellitesWriter),
-		  _decoder(new GPSLib::GPSSentenceDecoder) {}
+	GPSPublisher(const std::string &portName, int baudRate, bool ubx, const Writers &writers, const PublishPolicies &policies,
+		PublishingStage &stage, bool numbered) : 
+	  _portName(portName), _baudRate(baudRate), _ubx(ubx), _compact(!CORBA::is_nil(writers._compactPosition.in())),
+		  _fixOnly(CORBA::is_nil(writers._position.in()) && CORBA::is_nil(writers._compactPosition.in())),
+		  _sensorID(GetSensorID(portName)), _policies(policies), _stage(stage), _decoder(new GPSLib::GPSSentenceDecoder(GPSLib::SM_ALL, true)) {
+		_fix.Register(writers._fix.in(), _sensorID, numbered);
+		_position.Register(writers._position.in(), _sensorID, numbered);
+		_altitude.Register(writers._altitude.in(), _sensorID, numbered);
+		_course.Register(writers._course.in(), _sensorID, numbered);
+		_compactPosition.Register(writers._compactPosition.in(), _sensorID, numbered);
+		_compactAltitude.Register(writers._compactAltitude.in(), _sensorID, numbered);
+		_compactCourse.Register(writers._compactCourse.in(), _sensorID, numbered);
+		_satelliteInfo.Register(writers._satelliteInfo.in(), _sensorID, numbered);
+		_activeSatellites.Register(writers._activeSatellites.in(), _sensorID, numbered);
+	}
 	void Create(boost::asio::io_service &ios) {
 		try {
+			CreateConflators(ios);
+			InstallHandlers(ios);
 			_serialPort.reset(new ASIOLib::SerialPort(ios,  _portName));  
 			_serialPort->Open(boost::bind(&GPSPublisher::OnRead, shared_from_this(), _1, _2, _3), _baudRate);
+			if (_ubx)
+				SwitchToUBX();
 		} catch (const std::exception &e) {
 			std::cout << "GPSPublisher exception (create): " << e.what() << std::endl;		
 		}
@@ -150,8 +597,9 @@ public:
 };
 
 
+// on the one publisher all topics share
 template <typename TTypeSupport, typename TTypeSupportImpl, typename TDataWriter>
-TAO_Objref_Var_T<TDataWriter> CreateWriter(DDS::DomainParticipant_ptr dp, const char *topicName) {
+TAO_Objref_Var_T<TDataWriter> CreateWriter(DDS::DomainParticipant_ptr dp, DDS::Publisher_ptr pub, const QosProfile &qos, const char *topicName) {
 	TAO_Objref_Var_T<TTypeSupport> ts = new TTypeSupportImpl;
 	if (ts->register_type(dp, "") != DDS::RETCODE_OK)
 		throw DDSException("reigster_type() failed");
@@ -161,12 +609,9 @@ TAO_Objref_Var_T<TDataWriter> CreateWriter(DDS::DomainParticipant_ptr dp, const
 	if (0 == topic) 
 		throw DDSException("create_topic() failed");
 
-	DDS::Publisher_var pub = dp->create_publisher(PUBLISHER_QOS_DEFAULT, 0, OpenDDS::DCPS::DEFAULT_STATUS_MASK);
-	if (0 == pub) 
-		throw DDSException("create_publisher() failed");
-
 	DDS::DataWriterQos dw_qos;
 	pub->get_default_datawriter_qos(dw_qos);
+	qos.Apply(topicName, dw_qos);
 	DDS::DataWriter_var dw = pub->create_datawriter(topic, dw_qos, 0, OpenDDS::DCPS::DEFAULT_STATUS_MASK);
 	if (0 == dw) 
 		throw DDSException("create_datawriter() failed");
@@ -184,13 +629,32 @@ int main(int argc, char *argv[]) {
 	DDS::DomainParticipantFactory_var dpf;
 	DDS::DomainParticipant_var dp;
 	try {
-	  std::string portName, file;
+		std::vector<std::string> portNames;
 		int baudRate;
 		boost::program_options::options_description desc("Options");
 		desc.add_options()
 			("help,h", "help")
-			("port,p", boost::program_options::value<std::string>(&portName)->required(), "port name (required)")
-			("baud,b", boost::program_options::value<int>(&baudRate)->required(), "baud rate (required)")
+			("port,p", boost::program_options::value<std::vector<std::string> >(&portNames)->required()->composing(), "port name, repeated for each receiver (required)")
+			("baud,b", boost::program_options::value<int>(&baudRate)->required(), "baud rate of every port (required)")
+			("config,f", boost::program_options::value<std::string>(), "file of further options, one name = value a line - port may be given on as many lines as there are receivers")
+			("ubx,u", "switch a u-blox receiver to binary UBX output")
+			("compact,c", "publish position, altitude and course in fixed point, to the GPS_Compact* topics")
+			("fix", "also publish the merged GPS_Fix topic - every GGA and RMC is then fully decoded for it")
+			("fix-only,x", "publish only the merged GPS_Fix topic and GPS_SatelliteInfo, not the position, altitude, course and active satellite topics")
+			("rate,r", boost::program_options::value<double>(), "publish at most this many samples of each topic a second, the latest of each (default every sample)")
+			("distance-deadband", boost::program_options::value<double>()->default_value(0), "meters a position must move to be published again")
+			("altitude-deadband", boost::program_options::value<double>()->default_value(0), "meters altitude must change to be published again")
+			("course-deadband", boost::program_options::value<double>()->default_value(0), "degrees course must change to be published again, unless speed changes by its deadband")
+			("speed-deadband", boost::program_options::value<double>()->default_value(0), "knots speed must change to publish the course again, whatever its change (default any change)")
+			("dop-deadband", boost::program_options::value<double>()->default_value(0), "how much a dilution of precision must change to be published again")
+			("writer-threads", boost::program_options::value<unsigned int>()->default_value(1), "threads making DDS writes - with more than one, writes may be reordered")
+			("queue-size", boost::program_options::value<size_t>()->default_value(1024), "writes queued for the writer threads")
+			("queue-full", boost::program_options::value<std::string>()->default_value("drop-oldest"), "when the write queue is full: drop-oldest, drop-newest, or block (stalls decoding)")
+			("sequence,n", "number the samples of each sensor and topic, bar the compact ones, for subscribers to find gaps")
+			("qos,q", boost::program_options::value<std::string>()->default_value("default"), "QoS profile: default, low-latency or reliable - the same as the subscribers'")
+			("latency-budget", boost::program_options::value<long>(), "latency budget in milliseconds, in place of the profile's")
+			("transport-priority", boost::program_options::value<long>(), "transport priority of the position, altitude, course and fix writers, in place of the profile's")
+			("stats,s", boost::program_options::value<int>(), "log the write queue depth every this many seconds")
 			;
 	
 		boost::program_options::variables_map vm;
@@ -201,6 +665,9 @@ int main(int argc, char *argv[]) {
 			return -1;
 		}
 
+		if (vm.count("config"))  // options on the command line take precedence, except port, which is added to
+			boost::program_options::store(boost::program_options::parse_config_file<char>(vm["config"].as<std::string>().c_str(), desc), vm);
+
 		boost::program_options::notify(vm);
 
 		dpf = TheParticipantFactoryWithArgs(argc, argv);
@@ -208,19 +675,77 @@ int main(int argc, char *argv[]) {
 		if (0 == dp) 
 			throw DDSException("create_participant() failed");
 
-		const GPS::PositionDataDataWriter_var positionWriter = CREATE_WRITER(GPS::PositionData)(dp, "GPS_Position");
-		const GPS::AltitudeDataDataWriter_var altitudeWriter = CREATE_WRITER(GPS::AltitudeData)(dp, "GPS_Altitude");
-		const GPS::CourseDataDataWriter_var courseWriter = CREATE_WRITER(GPS::CourseData)(dp, "GPS_Course");
-		const GPS::SatelliteInfoDataDataWriter_var satelliteInfoWriter = CREATE_WRITER(GPS::SatelliteInfoData)(dp, "GPS_SatelliteInfo");
-		const GPS::ActiveSatellitesDataDataWriter_var activeSatellitesInfoWriter = CREATE_WRITER(GPS::ActiveSatellitesData)(dp, "GPS_ActiveSatellites");
+		DDS::Publisher_var pub = dp->create_publisher(PUBLISHER_QOS_DEFAULT, 0, OpenDDS::DCPS::DEFAULT_STATUS_MASK);
+		if (0 == pub) 
+			throw DDSException("create_publisher() failed");
+
+		QosProfile qos = QosProfile::Get(vm["qos"].as<std::string>());
+		if (vm.count("latency-budget"))
+			qos.SetLatencyBudget(vm["latency-budget"].as<long>());
+		if (vm.count("transport-priority"))
+			qos.SetTransportPriority(vm["transport-priority"].as<long>());
+
+		// one writer per topic for all receivers, each publishing its own instance on it
+		const bool fixOnly = vm.count("fix-only") != 0;  // GPS_Fix carries all of position, altitude, course and active satellites, PRNs included
+		Writers writers;
+		if (fixOnly || vm.count("fix"))
+			writers._fix = CREATE_WRITER(GPS::FixData)(dp, pub, qos, "GPS_Fix");
+		if (!fixOnly && vm.count("compact")) {
+			writers._compactPosition = CREATE_WRITER(GPS::CompactPositionData)(dp, pub, qos, "GPS_CompactPosition");
+			writers._compactAltitude = CREATE_WRITER(GPS::CompactAltitudeData)(dp, pub, qos, "GPS_CompactAltitude");
+			writers._compactCourse = CREATE_WRITER(GPS::CompactCourseData)(dp, pub, qos, "GPS_CompactCourse");
+		} else if (!fixOnly) {
+			writers._position = CREATE_WRITER(GPS::PositionData)(dp, pub, qos, "GPS_Position");
+			writers._altitude = CREATE_WRITER(GPS::AltitudeData)(dp, pub, qos, "GPS_Altitude");
+			writers._course = CREATE_WRITER(GPS::CourseData)(dp, pub, qos, "GPS_Course");
+		}
+		writers._satelliteInfo = CREATE_WRITER(GPS::SatelliteInfoData)(dp, pub, qos, "GPS_SatelliteInfo");
+		if (!fixOnly)
+			writers._activeSatellites = CREATE_WRITER(GPS::ActiveSatellitesData)(dp, pub, qos, "GPS_ActiveSatellites");
+
+		PublishPolicies policies;
+		boost::posix_time::time_duration interval(boost::posix_time::not_a_date_time);
+		if (vm.count("rate") && !(vm["rate"].as<double>() > 0))
+			throw std::invalid_argument("--rate must be more than 0");
+		if (vm.count("stats") && (vm["stats"].as<int>() <= 0))
+			throw std::invalid_argument("--stats must be at least 1 second");
+		if (vm.count("rate"))
+			interval = boost::posix_time::microseconds(static_cast<boost::int64_t>(1e6 / vm["rate"].as<double>()));
+		policies._position = GPSLib::PublishPolicy(interval, vm["distance-deadband"].as<double>());
+		policies._altitude = GPSLib::PublishPolicy(interval, vm["altitude-deadband"].as<double>());
+		policies._course = GPSLib::PublishPolicy(interval, vm["course-deadband"].as<double>());
+		policies._speedDeadband = vm["speed-deadband"].as<double>();
+		policies._activeSatellites = GPSLib::PublishPolicy(interval, vm["dop-deadband"].as<double>());
+		policies._satelliteInfo = GPSLib::PublishPolicy(interval);
+		policies._fix = GPSLib::PublishPolicy(interval, vm["distance-deadband"].as<double>());
+
+		ASIOLib::FullQueuePolicy queueFull;
+		const std::string queueFullName = vm["queue-full"].as<std::string>();
+		if (queueFullName == "drop-oldest")
+			queueFull = ASIOLib::FQ_DROP_OLDEST;
+		else if (queueFullName == "drop-newest")
+			queueFull = ASIOLib::FQ_DROP_NEWEST;
+		else if (queueFullName == "block")
+			queueFull = ASIOLib::FQ_BLOCK;
+		else
+			throw std::invalid_argument("--queue-full must be drop-oldest, drop-newest or block");
 
 		ASIOLib::Executor e;
+		PublishingStage stage(e.GetIOService(), vm["queue-size"].as<size_t>(), queueFull, vm["writer-threads"].as<unsigned int>());
+		if (vm.count("stats"))
+			stage.ReportStatsEvery(boost::posix_time::seconds(vm["stats"].as<int>()));
 		e.OnWorkerThreadError = [](boost::asio::io_service &, boost::system::error_code ec) { Log(std::string("GPSPublisher error (asio): ") + boost::lexical_cast<std::string>(ec)); };
 		e.OnWorkerThreadException = [](boost::asio::io_service &, const std::exception &ex) { Log(std::string("GPSPublisher exception (asio): ") + ex.what()); };
 
-		boost::shared_ptr<GPSPublisher> spd(new GPSPublisher(portName, baudRate, positionWriter, altitudeWriter, courseWriter, satelliteInfoWriter, activeSatellitesInfoWriter));  // for shared_from_this() to work inside of Reader, Reader must already be managed by a smart pointer
-		e.OnRun = boost::bind(&GPSPublisher::Create, spd, _1);
+		std::vector<boost::shared_ptr<GPSPublisher> > publishers;
+		for (size_t i = 0; i < portNames.size(); i++)
+			publishers.push_back(boost::shared_ptr<GPSPublisher>(new GPSPublisher(portNames[i], baudRate, vm.count("ubx") != 0, writers, policies, stage, vm.count("sequence") != 0)));  // for shared_from_this() to work inside of Reader, Reader must already be managed by a smart pointer
+		e.OnRun = [&](boost::asio::io_service &ios) {
+			for (size_t i = 0; i < publishers.size(); i++)
+				publishers[i]->Create(ios);
+		};
 		e.Run();
+		stage.Stop();
 	} catch (const std::exception &e) {
 		std::cout << "GPSPublisher exception (main): " << e.what() << std::endl;
 		return -1;
@@ -1,15 +1,232 @@
 // #include "../GPSDDSLib/GPSTypeSupportC.h"
 #include "../GPSDDSLib/GPSTypeSupportImpl.h"
 #include "../GPSDDSLib/DDSException.h"
+#include "../GPSDDSLib/QosProfiles.h"
 #include <dds/DCPS/Marked_Default_Qos.h>
 #include <dds/DCPS/Service_Participant.h>
 #include <dds/DCPS/WaitSet.h>
+#include <dds/DCPS/GuardCondition.h>
 #include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <stdexcept>
+#include <map>
+#include <vector>
 #include <boost/date_time.hpp>
 #include <boost/tuple/tuple.hpp>
+#include <boost/program_options.hpp>
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/bind.hpp>
+#include "../GPSLib/TopicStatistics.h"
+#include "../GPSLib/TrackStore.h"
+#include "../GPSLib/SpatialIndex.h"
+#include "../GPSLib/LatestStateTable.h"
+#include "../ASIOLib/OutputSink.h"
+#include "../ASIOLib/Executor.h"
+
+
+// latency from the publisher's serial read to here, and gaps in the sample numbers, for each topic read - a listener
+// records into its own topic's statistics, not through the map, and the map is only printed once every topic has
+// been added, so the map itself needs no locking
+class Statistics {
+	std::map<std::string, boost::shared_ptr<GPSLib::TopicStatistics> > _topics;
+public:
+	GPSLib::TopicStatistics &AddTopic(const std::string &topicName) {
+		boost::shared_ptr<GPSLib::TopicStatistics> &topic = _topics[topicName];
+		topic.reset(new GPSLib::TopicStatistics);
+		return *topic;
+	}
+
+	static void Record(GPSLib::TopicStatistics &topic, const char *sensorID, CORBA::ULong sequence, const DDS::SampleInfo &info) {
+		static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+		const double now = (boost::posix_time::microsec_clock::universal_time() - epoch).total_microseconds() / 1000.0;
+		const double sent = info.source_timestamp.sec * 1000.0 + info.source_timestamp.nanosec / 1e6;
+		topic.Add(sensorID, sequence, now - sent);
+	}
+
+	void Print(std::ostream &out) {
+		for (std::map<std::string, boost::shared_ptr<GPSLib::TopicStatistics> >::const_iterator it = _topics.begin(); it != _topics.end(); ++it) {
+			const GPSLib::TopicSummary summary = it->second->Take();
+			out << "Summary: " << it->first << " " << summary._samples << " samples " << summary._rate << "/s latency ms p50 " <<
+				summary._latency50 << " p90 " << summary._latency90 << " p99 " << summary._latency99 << " max " << summary._latencyMax <<
+				" gaps " << summary._gaps << " (" << summary._missing << " missing)" << std::endl;
+		}
+	}
+};
+
+
+// the number a sample was written with, 0 if it wasn't - the compact types carry none
+template <typename TSample>
+CORBA::ULong GetSequence(const TSample &sample) { return sample.sequence; }
+CORBA::ULong GetSequence(const GPS::CompactPositionData &) { return 0; }
+CORBA::ULong GetSequence(const GPS::CompactAltitudeData &) { return 0; }
+CORBA::ULong GetSequence(const GPS::CompactCourseData &) { return 0; }
+
+boost::posix_time::ptime ToTime(CORBA::ULongLong date) {
+	static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+	return epoch + boost::posix_time::milliseconds(date);
+}
+
+void Print(const GPS::PositionData &sample, std::ostream &out) {
+	out << "Position: " << sample.sensor_id << " " << ToTime(sample.date) << " " << sample.latitude << " " << sample.longitude << std::endl;
+}
+
+void Print(const GPS::AltitudeData &sample, std::ostream &out) {
+	out << "Altitude: " << sample.sensor_id << " " << ToTime(sample.date) << " " << sample.altitude << std::endl;
+}
+
+void Print(const GPS::CourseData &sample, std::ostream &out) {
+	out << "Course: " << sample.sensor_id << " " << ToTime(sample.date) << " " << sample.speed << " " << sample.course << std::endl;
+}
+
+// fixed point, converted back for display
+void Print(const GPS::CompactPositionData &sample, std::ostream &out) {
+	out << "Position: " << sample.sensor_id << " " << ToTime(sample.date) << " " << sample.latitude / 1e7 << " " << sample.longitude / 1e7 << std::endl;
+}
+
+void Print(const GPS::CompactAltitudeData &sample, std::ostream &out) {
+	out << "Altitude: " << sample.sensor_id << " " << ToTime(sample.date) << " " << sample.altitude / 1000.0 << std::endl;
+}
+
+void Print(const GPS::CompactCourseData &sample, std::ostream &out) {
+	out << "Course: " << sample.sensor_id << " " << ToTime(sample.date) << " " << sample.speed / 1000.0 << " " << sample.course / 100.0 << std::endl;
+}
+
+void Print(const GPS::FixData &sample, std::ostream &out) {
+	out << "Fix: " << sample.sensor_id << " " << ToTime(sample.date) << " " << sample.latitude << " " << sample.longitude << " " <<
+		sample.altitude << " " << sample.speed << " " << sample.course << " " << sample.quality << " " << sample.fixMode << " " <<
+		sample.numSatellites << " " << sample.pdop << " " << sample.hdop << " " << sample.vdop << " [";
+	for (CORBA::ULong i=0; i<sample.activeSatellites.length(); i++)
+		out << sample.activeSatellites[i] << " ";
+	out << "]" << std::endl;
+}
+
+void Print(const GPS::SatelliteInfoData &sample, std::ostream &out) {
+	out << "Satellite info: " << sample.sensor_id << " ";
+	for (CORBA::ULong i=0; i<sample.satelliteInfo.length(); i++) {
+		out << "[" << sample.satelliteInfo[i].prn << "," << sample.satelliteInfo[i].azimuth << "," << sample.satelliteInfo[i].elevation <<
+			"," << sample.satelliteInfo[i].snr << "]";
+	}
+	out << std::endl;
+}
+
+void Print(const GPS::ActiveSatellitesData &sample, std::ostream &out) {
+	out << "Active Satellites: " << sample.sensor_id << " " << sample.pdop << " " << sample.hdop << " " << 
+		sample.vdop << " [";
+	for (CORBA::ULong i=0; i<sample.activeSatellites.length(); i++)
+		out << sample.activeSatellites[i] << " ";
+	out << "]" << std::endl;
+}
+
+
+// where each sample read goes, besides its topic's statistics - the store, index and latest state are 0 unless asked for
+class Consumers {
+public:
+	ASIOLib::OutputSink *_sink;
+	GPSLib::TrackStore *_store;
+	GPSLib::SpatialIndex *_index;
+	GPSLib::LatestStateTable *_latest;
+
+	Consumers() : _sink(0), _store(0), _index(0), _latest(0) {}
+
+	void KeepPosition(const char *sensorID, CORBA::ULongLong date, double latitude, double longitude) const {
+		if (_index)
+			_index->Update(sensorID, latitude, longitude);
+		if (_latest)
+			_latest->UpdatePosition(sensorID, date, latitude, longitude);
+	}
+
+	void KeepAltitude(const char *sensorID, CORBA::ULongLong date, double altitude) const {
+		if (_latest)
+			_latest->UpdateAltitude(sensorID, date, altitude);
+	}
+
+	void KeepCourse(const char *sensorID, CORBA::ULongLong date, double speed, double course) const {
+		if (_latest)
+			_latest->UpdateCourse(sensorID, date, speed, course);
+	}
+};
+
+// Only the merged fix is kept in the track store - the other topics each carry a part of it.  Every position moves its
+// sensor in the spatial index, and each part of a sensor's state, from whichever topic, updates the latest state table.
+template <typename TSample>
+void Keep(const Consumers &, const TSample &) {}
+
+void Keep(const Consumers &consumers, const GPS::FixData &sample) {
+	if (consumers._store)
+		consumers._store->Add(sample.sensor_id.in(), GPSLib::TrackPoint(ToTime(sample.date), sample.latitude, sample.longitude,
+			sample.altitude, sample.speed, sample.course));
+	consumers.KeepPosition(sample.sensor_id.in(), sample.date, sample.latitude, sample.longitude);
+	consumers.KeepAltitude(sample.sensor_id.in(), sample.date, sample.altitude);
+	consumers.KeepCourse(sample.sensor_id.in(), sample.date, sample.speed, sample.course);
+}
+
+void Keep(const Consumers &consumers, const GPS::PositionData &sample) {
+	consumers.KeepPosition(sample.sensor_id.in(), sample.date, sample.latitude, sample.longitude);
+}
+
+void Keep(const Consumers &consumers, const GPS::AltitudeData &sample) {
+	consumers.KeepAltitude(sample.sensor_id.in(), sample.date, sample.altitude);
+}
+
+void Keep(const Consumers &consumers, const GPS::CourseData &sample) {
+	consumers.KeepCourse(sample.sensor_id.in(), sample.date, sample.speed, sample.course);
+}
+
+void Keep(const Consumers &consumers, const GPS::CompactPositionData &sample) {
+	consumers.KeepPosition(sample.sensor_id.in(), sample.date, sample.latitude / 1e7, sample.longitude / 1e7);
+}
+
+void Keep(const Consumers &consumers, const GPS::CompactAltitudeData &sample) {
+	consumers.KeepAltitude(sample.sensor_id.in(), sample.date, sample.altitude / 1000.0);
+}
 
+void Keep(const Consumers &consumers, const GPS::CompactCourseData &sample) {
+	consumers.KeepCourse(sample.sensor_id.in(), sample.date, sample.speed / 1000.0, sample.course / 100.0);
+}
+
+
+// sensors within a radius of a point, counted in each summary
+class Geofence {
+public:
+	double _latitude, _longitude, _meters;
+
+	explicit Geofence(const std::string &s) {
+		if (std::sscanf(s.c_str(), "%lf,%lf,%lf", &_latitude, &_longitude, &_meters) != 3)
+			throw std::invalid_argument("--geofence must be latitude,longitude,meters");
+	}
+};
+
+void PrintSummary(Statistics &statistics, const Consumers &consumers, const Geofence *geofence) {
+	std::ostringstream out;
+	statistics.Print(out);
+	if (consumers._store)
+		out << "Store: " << consumers._store->GetSensors().size() << " sensors " << consumers._store->GetSampleCount() << " fixes " <<
+			consumers._store->GetRejected() << " out of order" << std::endl;
+	if (consumers._latest)
+		out << "Latest: " << consumers._latest->GetSize() << " sensors " << consumers._latest->GetRefused() << " refused" << std::endl;
+	if (geofence) {
+		std::vector<GPSLib::SpatialMatch> inside;
+		consumers._index->InRadius(geofence->_latitude, geofence->_longitude, geofence->_meters, inside);
+		out << "Geofence: " << inside.size() << " of " << consumers._index->GetSize() << " sensors within " << geofence->_meters << "m";
+		for (size_t i = 0; i < inside.size(); i++)
+			out << " " << inside[i]._sensorID;
+		out << std::endl;
+	}
+	consumers._sink->SubmitText(out.str());
+}
+
+
+// a record for the sink - the sample is copied into it, as the reader's loan is returned long before it is written
+template <typename TSample>
+void PrintRecord(const TSample &sample, std::ostream &out) {
+	Print(sample, out);
+}
 
-class DataReaderListenerImpl
+
+class DataReaderListenerBase
 	: public virtual OpenDDS::DCPS::LocalObject<DDS::DataReaderListener> {
 public:
 	virtual void on_requested_deadline_missed(
@@ -28,9 +245,6 @@ public:
 		DDS::DataReader_ptr reader,
 		const DDS::LivelinessChangedStatus& status) {}
 
-	virtual void on_data_available(
-		DDS::DataReader_ptr reader);
-
 	virtual void on_subscription_matched(
 		DDS::DataReader_ptr reader,
 		const DDS::SubscriptionMatchedStatus& status) {}
@@ -40,92 +254,140 @@ public:
 		const DDS::SampleLostStatus& status) {}
 };
 
+// One listener per topic, holding its own typed reader, so a callback needs no _narrow to find out which topic it is
+// for.  Each wake-up drains the reader - take() with LENGTH_UNLIMITED hands over every sample available as a loan of
+// the reader's own, and the loop catches those that arrive while a batch is being handled.  Samples are handed to
+// the output sink rather than printed, so the listener never waits on the console.  With --waitset the listener
+// isn't installed, and its Drain is called by the WaitSetDispatcher instead.
+template <typename TSample, typename TSeq, typename TDataReader>
+class TopicListener : public DataReaderListenerBase {
+	TDataReader *const _reader;  // not a reference of its own - the reader holds its listener, and outlives its callbacks
+	GPSLib::TopicStatistics &_statistics;
+	const Consumers _consumers;
+public:
+	TopicListener(TDataReader *reader, GPSLib::TopicStatistics &statistics, const Consumers &consumers) :
+		_reader(reader), _statistics(statistics), _consumers(consumers) {}
 
-void DataReaderListenerImpl::on_data_available(DDS::DataReader_ptr reader) {
-	const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
-	DDS::SampleInfo info;
-
-	GPS::PositionDataDataReader_var positionReader =
-		GPS::PositionDataDataReader::_narrow(reader);
-
-	if (positionReader) {
-		GPS::PositionData sample;
-		DDS::ReturnCode_t error = positionReader->take_next_sample(sample, info);
-		if ((error == DDS::RETCODE_OK) && info.valid_data) {
-			boost::posix_time::ptime time(epoch + boost::posix_time::time_duration(boost::posix_time::milliseconds(sample.date)));
-			std::cout << "Position: " << sample.sensor_id << " " << time << " " << sample.latitude << " " << sample.longitude << std::endl;
-		}
-		return;
+	virtual void on_data_available(DDS::DataReader_ptr) {
+		Drain();
 	}
 
-
-	GPS::AltitudeDataDataReader_var altitudeReader =
-		GPS::AltitudeDataDataReader::_narrow(reader);
-
-	if (altitudeReader) {
-		GPS::AltitudeData sample;
-		DDS::ReturnCode_t error = altitudeReader->take_next_sample(sample, info);
-		if ((error == DDS::RETCODE_OK) && info.valid_data) {
-			boost::posix_time::ptime time(epoch + boost::posix_time::time_duration(boost::posix_time::milliseconds(sample.date)));
-			std::cout << "Altitude: " << sample.sensor_id << " " << time << " " << sample.altitude << std::endl;
+	void Drain() {
+		TSeq samples;
+		DDS::SampleInfoSeq infos;
+		while (true) {
+			const DDS::ReturnCode_t error = _reader->take(samples, infos, DDS::LENGTH_UNLIMITED,
+				DDS::ANY_SAMPLE_STATE, DDS::ANY_VIEW_STATE, DDS::ANY_INSTANCE_STATE);
+			if (error != DDS::RETCODE_OK)
+				return;  // RETCODE_NO_DATA once drained
+
+			for (CORBA::ULong i = 0; i < samples.length(); i++)
+				if (infos[i].valid_data) {
+					Statistics::Record(_statistics, samples[i].sensor_id.in(), GetSequence(samples[i]), infos[i]);
+					Keep(_consumers, samples[i]);
+					_consumers._sink->Submit(boost::bind(&PrintRecord<TSample>, samples[i], _1));
+				}
+			_reader->return_loan(samples, infos);
 		}
-		return;
 	}
+};
+
 
 
-	GPS::CourseDataDataReader_var courseReader =
-		GPS::CourseDataDataReader::_narrow(reader);
+// The alternative to listeners (--waitset): a ReadCondition for each reader, all on one WaitSet waited on by a thread
+// of its own, which hands each topic with data to a pool of threads to drain.  A topic's condition is detached from
+// the WaitSet while the topic is being drained, and attached again once it has been, so each topic is drained by one
+// thread at a time, in order, while different topics are drained in parallel - and none on the transport's threads.
+class WaitSetDispatcher : private boost::noncopyable {
+	class Topic {
+	public:
+		DDS::ReadCondition_var _condition;
+		DDS::DataReaderListener_var _listener;  // not installed, but holds the object _drain is bound to
+		boost::function<void ()> _drain;
+	};
+
+	DDS::WaitSet_var _waitSet;
+	DDS::GuardCondition_var _stop;
+	std::vector<Topic> _topics;  // all added before Start
+	ASIOLib::Executor _executor;
+	boost::scoped_ptr<boost::asio::io_service::work> _work;
+	boost::thread _waitThread, _executorThread;
+
+	void WaitThread() {
+		while (true) {
+			DDS::ConditionSeq active;
+			const DDS::Duration_t forever = { DDS::DURATION_INFINITE_SEC, DDS::DURATION_INFINITE_NSEC };
+			if (_waitSet->wait(active, forever) != DDS::RETCODE_OK) {
+				std::cout << "GPSSubscriber: WaitSet wait() failed" << std::endl;
+				return;
+			}
 
-	if (courseReader) {
-		GPS::CourseData sample;
-		DDS::ReturnCode_t error = courseReader->take_next_sample(sample, info);
-		if ((error == DDS::RETCODE_OK) && info.valid_data) {
-			boost::posix_time::ptime time(epoch + boost::posix_time::time_duration(boost::posix_time::milliseconds(sample.date)));
-			std::cout << "Course: " << sample.sensor_id << " " << time << " " << sample.speed << " " << sample.course << std::endl;
+			// topics that woke the wait along with the stop are still drained
+			bool stop = false;
+			for (CORBA::ULong i = 0; i < active.length(); i++) {
+				if (active[i].in() == _stop.in())
+					stop = true;
+				for (size_t t = 0; t < _topics.size(); t++)
+					if (active[i].in() == _topics[t]._condition.in()) {
+						_waitSet->detach_condition(_topics[t]._condition);
+						_executor.GetIOService().post(boost::bind(&WaitSetDispatcher::Drain, this, t));
+					}
+			}
+			if (stop)
+				return;
 		}
-		return;
 	}
 
+	void Drain(size_t topic) {
+		_topics[topic]._drain();
+		_waitSet->attach_condition(_topics[topic]._condition);  // wakes the wait at once if more arrived meanwhile
+	}
+public:
+	WaitSetDispatcher() : _waitSet(new DDS::WaitSet), _stop(new DDS::GuardCondition) {
+		_waitSet->attach_condition(_stop);
+	}
 
-	GPS::SatelliteInfoDataDataReader_var satelliteInfoReader =
-		GPS::SatelliteInfoDataDataReader::_narrow(reader);
+	~WaitSetDispatcher() {
+		Stop();
+	}
 
-	if (satelliteInfoReader) {
-		GPS::SatelliteInfoData sample;
-		DDS::ReturnCode_t error = satelliteInfoReader->take_next_sample(sample, info);
-		if ((error == DDS::RETCODE_OK) && info.valid_data) {
-			std::cout << "Satellite info: " << sample.sensor_id << " ";
-			for (CORBA::ULong i=0; i<sample.satelliteInfo.length(); i++) {
-				std::cout << "[" << sample.satelliteInfo[i].prn << "," << sample.satelliteInfo[i].azimuth << "," << sample.satelliteInfo[i].elevation <<
-					"," << sample.satelliteInfo[i].snr << "]";
-			}
-			std::cout << std::endl;
-		}
-		return;
+	void Add(DDS::DataReader_ptr reader, DDS::DataReaderListener_ptr listener, const boost::function<void ()> &drain) {
+		Topic topic;
+		topic._condition = reader->create_readcondition(DDS::ANY_SAMPLE_STATE, DDS::ANY_VIEW_STATE, DDS::ANY_INSTANCE_STATE);
+		if (0 == topic._condition)
+			throw DDSException("create_readcondition() failed");
+		topic._listener = DDS::DataReaderListener::_duplicate(listener);
+		topic._drain = drain;
+		_topics.push_back(topic);
+		_waitSet->attach_condition(topic._condition);
 	}
 
-	GPS::ActiveSatellitesDataDataReader_var activeSatellitesReader =
-		GPS::ActiveSatellitesDataDataReader::_narrow(reader);
+	void Start(unsigned int threads) {
+		_work.reset(new boost::asio::io_service::work(_executor.GetIOService()));
+		_executorThread = boost::thread(boost::bind(&ASIOLib::Executor::Run, &_executor, threads));
+		_waitThread = boost::thread(boost::bind(&WaitSetDispatcher::WaitThread, this));
+	}
 
-	if (activeSatellitesReader) {
-		GPS::ActiveSatellitesData sample;
-		DDS::ReturnCode_t error = activeSatellitesReader->take_next_sample(sample, info);
-		if ((error == DDS::RETCODE_OK) && info.valid_data) {
-			std::cout << "Active Satellites: " << sample.sensor_id << " " << sample.pdop << " " << sample.hdop << " " << 
-				sample.vdop << " [";
-			for (CORBA::ULong i=0; i<sample.activeSatellites.length(); i++)
-				std::cout << sample.activeSatellites[i] << " ";
-			std::cout << "]" << std::endl;
+	// drains already handed to the pool are finished, then each topic is drained once more on this thread, for the
+	// samples that arrived since the last wake
+	void Stop() {
+		if (!_waitThread.joinable())
+			return;
+		_stop->set_trigger_value(true);
+		_waitThread.join();
+		_work.reset();
+		_executorThread.join();
+		for (size_t t = 0; t < _topics.size(); t++) {
+			_waitSet->detach_condition(_topics[t]._condition);
+			_topics[t]._drain();
 		}
-		return;
 	}
-
-}
-
+};
 
 
-template <typename TTypeSupport, typename TTypeSupportImpl, typename TDataReader>
-TAO_Objref_Var_T<TDataReader> CreateReader(DDS::DomainParticipant_ptr dp, DDS::DataReaderListener_ptr listener, const char *topicName) {
+template <typename TTypeSupport, typename TTypeSupportImpl, typename TDataReader, typename TSample, typename TSeq>
+TAO_Objref_Var_T<TDataReader> CreateReader(DDS::DomainParticipant_ptr dp, Statistics &statistics, const Consumers &consumers,
+	WaitSetDispatcher *dispatcher, const QosProfile &qos, const char *topicName) {
 	TAO_Objref_Var_T<TTypeSupport> ts = new TTypeSupportImpl;
 	if (ts->register_type(dp, "") != DDS::RETCODE_OK)
 		throw DDSException("reigster_type() failed");
@@ -141,7 +403,8 @@ TAO_Objref_Var_T<TDataReader> CreateReader(DDS::DomainParticipant_ptr dp, DDS::D
 
 	DDS::DataReaderQos dr_qos;
 	sub->get_default_datareader_qos(dr_qos);
-	DDS::DataReader_var dr = sub->create_datareader(topic, dr_qos, listener, OpenDDS::DCPS::DEFAULT_STATUS_MASK);
+	qos.Apply(topicName, dr_qos);
+	DDS::DataReader_var dr = sub->create_datareader(topic, dr_qos, 0, OpenDDS::DCPS::DEFAULT_STATUS_MASK);
 	if (0 == dr) 
 		throw DDSException("create_datareader() failed");
 
@@ -149,6 +412,15 @@ TAO_Objref_Var_T<TDataReader> CreateReader(DDS::DomainParticipant_ptr dp, DDS::D
 	if (0 == ndr) 
 		throw DDSException("reader _narrow() failed");
 
+	// the listener is given the typed reader, so is set once the reader exists
+	TopicListener<TSample, TSeq, TDataReader> *const topicListener =
+		new TopicListener<TSample, TSeq, TDataReader>(ndr.in(), statistics.AddTopic(topicName), consumers);
+	DDS::DataReaderListener_var listener(topicListener);
+	if (dispatcher)
+		dispatcher->Add(ndr.in(), listener.in(), boost::bind(&TopicListener<TSample, TSeq, TDataReader>::Drain, topicListener));
+	else if (ndr->set_listener(listener, DDS::DATA_AVAILABLE_STATUS) != DDS::RETCODE_OK)
+		throw DDSException("set_listener() failed");
+
 	return ndr;
 }
 
@@ -178,38 +450,151 @@ void WaitForPublisherToComplete(DDS::DataReader_ptr dr) {
 }
 
 
-#define CREATE_READER(X) CreateReader<X##TypeSupport, X##TypeSupportImpl, X##DataReader>
+// interrupts and joins a thread as it goes out of scope, so an exception doesn't leave it running - or joinable,
+// which would terminate
+class InterruptingJoin : private boost::noncopyable {
+	boost::thread &_thread;
+public:
+	explicit InterruptingJoin(boost::thread &thread) : _thread(thread) {}
+	~InterruptingJoin() {
+		if (_thread.joinable()) {
+			_thread.interrupt();
+			_thread.join();
+		}
+	}
+};
+
+
+#define CREATE_READER(X) CreateReader<X##TypeSupport, X##TypeSupportImpl, X##DataReader, X, X##Seq>
 
 int main(int argc, char *argv[]) {
 	DDS::DomainParticipantFactory_var dpf;
 	DDS::DomainParticipant_var dp;
+	// these outlive the readers' listeners, which are deleted with the participant's contained entities on every path
+	// out of the try below
+	Statistics statistics;
+	boost::scoped_ptr<ASIOLib::OutputSink> sink;
+	boost::scoped_ptr<GPSLib::TrackStore> store;
+	boost::scoped_ptr<GPSLib::SpatialIndex> index;
+	boost::scoped_ptr<GPSLib::LatestStateTable> latest;
+	boost::scoped_ptr<WaitSetDispatcher> dispatcher;
+	int result = 0;
 	try {
+		boost::program_options::options_description desc("Options");
+		desc.add_options()
+			("help,h", "help")
+			("compact,c", "read position, altitude and course from the fixed point GPS_Compact* topics")
+			("fix-only,x", "read only the merged GPS_Fix topic and satellite info - published with GPSPublisher --fix or --fix-only")
+			("qos,q", boost::program_options::value<std::string>()->default_value("default"), "QoS profile: default, low-latency or reliable - the same as the publisher's")
+			("latency-budget", boost::program_options::value<long>(), "latency budget in milliseconds, in place of the profile's - at least the publisher's")
+			("summary,s", boost::program_options::value<int>(), "print the latency, rate and gaps of each topic every this many seconds, and at the end")
+			("history", boost::program_options::value<int>(), "keep each sensor's fixes of the last this many minutes in memory - the summary reports the store's size")
+			("geofence", boost::program_options::value<std::string>(), "latitude,longitude,meters - the summary lists the sensors within the circle, from an index of their latest positions (requires --summary)")
+			("latest", boost::program_options::value<size_t>(), "keep the latest position, altitude and course of up to this many sensors, for lookups without locks")
+			("waitset,w", boost::program_options::value<unsigned int>(), "drain the readers with this many threads of our own, woken by a WaitSet, rather than in listeners on the transport's threads")
+			("output-queue", boost::program_options::value<size_t>()->default_value(8192), "samples waiting to be printed before more are dropped")
+			("output-block", "wait for room to print a sample rather than drop it - slows the readers to the console's pace")
+			;
+
+		boost::program_options::variables_map vm;
+		boost::program_options::store(boost::program_options::command_line_parser(argc, argv).options(desc).allow_unregistered().run(), vm);
+		if (vm.count("help")) {
+			std::cout << desc << "\n";
+			return -1;
+		}
+		boost::program_options::notify(vm);
+
 		dpf = TheParticipantFactoryWithArgs(argc, argv);
 		dp = dpf->create_participant(42, PARTICIPANT_QOS_DEFAULT, 0, OpenDDS::DCPS::DEFAULT_STATUS_MASK);
 		if (0 == dp) 
 			throw DDSException("create_participant() failed");
 
-		DDS::DataReaderListener_var listener(new DataReaderListenerImpl);
-		const GPS::PositionDataDataReader_var positonReader = CREATE_READER(GPS::PositionData)(dp, listener, "GPS_Position");
-		const GPS::AltitudeDataDataReader_var altitudeReader =  CREATE_READER(GPS::AltitudeData)(dp, listener, "GPS_Altitude");
-		const GPS::CourseDataDataReader_var courseReader = CREATE_READER(GPS::CourseData)(dp, listener, "GPS_Course");
-		const GPS::SatelliteInfoDataDataReader_var satelliteInfoReader = CREATE_READER(GPS::SatelliteInfoData)(dp, listener, "GPS_SatelliteInfo");
-		const GPS::ActiveSatellitesDataDataReader_var activeSatellitesInfoReader = CREATE_READER(GPS::ActiveSatellitesData)(dp, listener, "GPS_ActiveSatellites");
+		QosProfile qos = QosProfile::Get(vm["qos"].as<std::string>());
+		if (vm.count("latency-budget"))
+			qos.SetLatencyBudget(vm["latency-budget"].as<long>());
+
+		sink.reset(new ASIOLib::OutputSink(std::cout, vm["output-queue"].as<size_t>(), 64 * 1024, boost::posix_time::milliseconds(100),
+			vm.count("output-block") ? ASIOLib::FQ_BLOCK : ASIOLib::FQ_DROP_NEWEST));
+		if (vm.count("history"))
+			store.reset(new GPSLib::TrackStore(boost::posix_time::minutes(vm["history"].as<int>())));
+		if (vm.count("summary") && (vm["summary"].as<int>() <= 0))
+			throw std::invalid_argument("--summary must be at least 1 second");
+		if (vm.count("geofence") && !vm.count("summary"))
+			throw std::invalid_argument("--geofence is only reported in the summary, so requires --summary");
+		boost::scoped_ptr<Geofence> geofence(vm.count("geofence") ? new Geofence(vm["geofence"].as<std::string>()) : 0);
+		if (geofence)
+			index.reset(new GPSLib::SpatialIndex);
+		if (vm.count("waitset")) {
+			if (vm["waitset"].as<unsigned int>() < 1)
+				throw std::invalid_argument("--waitset must be at least 1 thread");
+			dispatcher.reset(new WaitSetDispatcher);
+		}
+		Consumers consumers;
+		consumers._sink = sink.get();
+		consumers._store = store.get();
+		consumers._index = index.get();
+		if (vm.count("latest"))
+			latest.reset(new GPSLib::LatestStateTable(GPSLib::LatestStateTable::CapacityFor(vm["latest"].as<size_t>())));
+		consumers._latest = latest.get();
+		std::vector<DDS::DataReader_var> readers;  // _retn(), or the typed var returned would release its reader
+		readers.push_back(CREATE_READER(GPS::FixData)(dp, statistics, consumers, dispatcher.get(), qos, "GPS_Fix")._retn());
+		if (!vm.count("fix-only")) {
+			if (vm.count("compact")) {
+				readers.push_back(CREATE_READER(GPS::CompactPositionData)(dp, statistics, consumers, dispatcher.get(), qos, "GPS_CompactPosition")._retn());
+				readers.push_back(CREATE_READER(GPS::CompactAltitudeData)(dp, statistics, consumers, dispatcher.get(), qos, "GPS_CompactAltitude")._retn());
+				readers.push_back(CREATE_READER(GPS::CompactCourseData)(dp, statistics, consumers, dispatcher.get(), qos, "GPS_CompactCourse")._retn());
+			} else {
+				readers.push_back(CREATE_READER(GPS::PositionData)(dp, statistics, consumers, dispatcher.get(), qos, "GPS_Position")._retn());
+				readers.push_back(CREATE_READER(GPS::AltitudeData)(dp, statistics, consumers, dispatcher.get(), qos, "GPS_Altitude")._retn());
+				readers.push_back(CREATE_READER(GPS::CourseData)(dp, statistics, consumers, dispatcher.get(), qos, "GPS_Course")._retn());
+			}
+			readers.push_back(CREATE_READER(GPS::ActiveSatellitesData)(dp, statistics, consumers, dispatcher.get(), qos, "GPS_ActiveSatellites")._retn());
+		}
+		readers.push_back(CREATE_READER(GPS::SatelliteInfoData)(dp, statistics, consumers, dispatcher.get(), qos, "GPS_SatelliteInfo")._retn());
+
+		if (dispatcher)
+			dispatcher->Start(vm["waitset"].as<unsigned int>());
+
+		boost::thread summaryThread;
+		const InterruptingJoin summaryThreadGuard(summaryThread);
+		if (vm.count("summary")) {
+			const int seconds = vm["summary"].as<int>();
+			summaryThread = boost::thread([&statistics, &consumers, &geofence, seconds]() {
+				try {
+					while (true) {
+						boost::this_thread::sleep(boost::posix_time::seconds(seconds));
+						PrintSummary(statistics, consumers, geofence.get());
+					}
+				} catch (const boost::thread_interrupted &) {}
+			});
+		}
+
+		for (size_t i = 0; i < readers.size(); i++)
+			WaitForPublisherToComplete(readers[i]);
+		if (dispatcher)
+			dispatcher->Stop();
+
+		if (vm.count("summary")) {
+			summaryThread.interrupt();
+			summaryThread.join();
+			PrintSummary(statistics, consumers, geofence.get());
+		}
 
-		WaitForPublisherToComplete(positonReader);
-		WaitForPublisherToComplete(altitudeReader);
-		WaitForPublisherToComplete(courseReader);
-		WaitForPublisherToComplete(satelliteInfoReader);
-		WaitForPublisherToComplete(activeSatellitesInfoReader);
+		sink->Stop();
+		if (sink->GetDropped() > 0)
+			std::cout << "GPSSubscriber: " << sink->GetDropped() << " samples not printed, the output queue being full" << std::endl;
 
 	} catch (const std::exception &e) {
 		std::cout << "GPSSubscriber exception: " << e.what() << std::endl;
-		return -1;
+		result = -1;
 	} catch (const CORBA::Exception &e) {
 		e._tao_print_exception("GPSSubscriber exception: ");
-		return -1;
+		result = -1;
 	} 
 
+	// the dispatcher's conditions are detached before the participant deletes them
+	if (dispatcher)
+		dispatcher->Stop();
 	if (0 != dp)
 		dp->delete_contained_entities();
 	if (0 != dpf)
@@ -217,5 +602,5 @@ int main(int argc, char *argv[]) {
 
 	TheServiceParticipant->shutdown();
 
-	return 0;
+	return result;
 }
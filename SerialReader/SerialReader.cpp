@@ -1,5 +1,6 @@
 #include "../ASIOLib/Executor.h"
 #include "../ASIOLib/SerialPort.h"
+#include "../ASIOLib/OutputSink.h"
 #include <boost/thread.hpp>
 #include <boost/date_time.hpp>
 #include <boost/program_options.hpp>
@@ -18,13 +19,14 @@ class SerialReader : private boost::noncopyable, public boost::enable_shared_fro
 	std::string _portName;
 	unsigned int _baudRate;
 	const boost::scoped_ptr<boost::archive::text_oarchive> &_oa;
+	ASIOLib::OutputSink &_sink;
 	boost::posix_time::ptime _lastRead;
 
 	void OnRead(boost::asio::io_service &ios, const std::vector<unsigned char> &buffer, size_t bytesRead);
 	
 public:
-	SerialReader(const std::string &portName, int baudRate, const boost::scoped_ptr<boost::archive::text_oarchive> &oa) : 
-	  _portName(portName), _baudRate(baudRate), _oa(oa) {}
+	SerialReader(const std::string &portName, int baudRate, const boost::scoped_ptr<boost::archive::text_oarchive> &oa, ASIOLib::OutputSink &sink) : 
+	  _portName(portName), _baudRate(baudRate), _oa(oa), _sink(sink) {}
 	void Create(boost::asio::io_service &ios) {
 		try {
 			_serialPort.reset(new ASIOLib::SerialPort(ios,  _portName));  
@@ -42,15 +44,15 @@ void SerialReader::OnRead(boost::asio::io_service &, const std::vector<unsigned
 	if (_lastRead == boost::posix_time::not_a_date_time)
 		_lastRead = now;
 
-	const std::vector<unsigned char> v(buffer.begin(), buffer.begin()+bytesRead);
-
 	if (_oa) { 		
+		const std::vector<unsigned char> v(buffer.begin(), buffer.begin()+bytesRead);
 		const uint64_t offset = (now-_lastRead).total_milliseconds();
 		*_oa << offset << v;
 	}
 	_lastRead = now;
 
-	std::copy(v.begin(), v.end(), std::ostream_iterator<unsigned char>(std::cout, ""));
+	// echoed by the sink's thread, so the read goes straight back to the port
+	_sink.SubmitBytes(&buffer[0], bytesRead);
 }
 
 
@@ -80,13 +82,19 @@ int main(int argc, char *argv[]) {
 	const boost::scoped_ptr<std::ostream> out(file.empty() ? 0 : new std::ofstream(file.c_str()));
 	const boost::scoped_ptr<boost::archive::text_oarchive> archive(file.empty() ? 0 : new boost::archive::text_oarchive(*out));
 
+	// a dropped chunk would corrupt the echoed byte stream, so the reads wait for the console instead
+	ASIOLib::OutputSink sink(std::cout, 8192, 64 * 1024, boost::posix_time::milliseconds(100), ASIOLib::FQ_BLOCK);
+
 	ASIOLib::Executor e;
 	e.OnWorkerThreadError = [](boost::asio::io_service &, boost::system::error_code ec) { Log(std::string("SerialReader error (asio): ") + boost::lexical_cast<std::string>(ec)); };
 	e.OnWorkerThreadException = [](boost::asio::io_service &, const std::exception &ex) { Log(std::string("SerialReader exception (asio): ") + ex.what()); };
 
-	const boost::shared_ptr<SerialReader> sp(new SerialReader(portName, baudRate, archive));  // for shared_from_this() to work inside of Reader, Reader must already be managed by a smart pointer
+	const boost::shared_ptr<SerialReader> sp(new SerialReader(portName, baudRate, archive, sink));  // for shared_from_this() to work inside of Reader, Reader must already be managed by a smart pointer
 	e.OnRun = boost::bind(&SerialReader::Create, sp, _1);
 	e.Run();
 
+	sink.Stop();
+	if (sink.GetDropped() > 0)
+		std::cout << "SerialReader: " << sink.GetDropped() << " reads not echoed, the output queue being full" << std::endl;
 	return 0;
 }
@@ -0,0 +1,65 @@
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/thread.hpp>
+#include "../ASIOLib/BoundedQueue.h"
+
+BOOST_AUTO_TEST_CASE(BoundedQueueDropNewestTest)
+{
+	ASIOLib::BoundedQueue<int> q(3, ASIOLib::FQ_DROP_NEWEST);
+	BOOST_REQUIRE(q.Push(1));
+	BOOST_REQUIRE(q.Push(2));
+	BOOST_REQUIRE(q.Push(3));
+	BOOST_REQUIRE(!q.Push(4));
+	BOOST_REQUIRE_EQUAL(3, q.GetDepth());
+	BOOST_REQUIRE_EQUAL(1, q.GetDropped());
+
+	int item;
+	BOOST_REQUIRE(q.Pop(item));
+	BOOST_REQUIRE_EQUAL(1, item);
+	BOOST_REQUIRE(q.Push(5));  // wraps around the ring
+	for (int expected = 2; expected <= 5; expected++) {
+		if (expected == 4)
+			continue;
+		BOOST_REQUIRE(q.Pop(item));
+		BOOST_REQUIRE_EQUAL(expected, item);
+	}
+	BOOST_REQUIRE_EQUAL(0, q.GetDepth());
+	BOOST_REQUIRE_EQUAL(3, q.GetHighWater());
+}
+
+BOOST_AUTO_TEST_CASE(BoundedQueueDropOldestTest)
+{
+	ASIOLib::BoundedQueue<int> q(2, ASIOLib::FQ_DROP_OLDEST);
+	BOOST_REQUIRE(q.Push(1));
+	BOOST_REQUIRE(q.Push(2));
+	BOOST_REQUIRE(!q.Push(3));
+	BOOST_REQUIRE_EQUAL(1, q.GetDropped());
+
+	int item;
+	BOOST_REQUIRE(q.Pop(item));
+	BOOST_REQUIRE_EQUAL(2, item);
+	BOOST_REQUIRE(q.Pop(item));
+	BOOST_REQUIRE_EQUAL(3, item);
+}
+
+BOOST_AUTO_TEST_CASE(BoundedQueueThreadsTest)
+{
+	// a blocking producer against a consumer thread - nothing lost, in order, and the consumer ends on Stop
+	ASIOLib::BoundedQueue<int> q(4, ASIOLib::FQ_BLOCK);
+	std::vector<int> consumed;
+	boost::thread consumer([&]() {
+		int item;
+		while (q.Pop(item))
+			consumed.push_back(item);
+	});
+	for (int i = 0; i < 1000; i++)
+		BOOST_REQUIRE(q.Push(i));
+	q.Stop();
+	consumer.join();
+
+	BOOST_REQUIRE_EQUAL(1000, consumed.size());
+	for (int i = 0; i < 1000; i++)
+		BOOST_REQUIRE_EQUAL(i, consumed[i]);
+	BOOST_REQUIRE_EQUAL(0, q.GetDropped());
+	BOOST_REQUIRE(q.GetHighWater() <= 4);
+	BOOST_REQUIRE(!q.Push(0));
+}
@@ -0,0 +1,97 @@
+#include <boost/test/auto_unit_test.hpp>
+#include <vector>
+#include <cmath>
+#include "../GPSLib/Conflator.h"
+#include "../GPSLib/Geodesy.h"
+
+namespace {
+	typedef GPSLib::Conflator<std::string, double> DoubleConflator;
+	typedef std::vector<std::pair<std::string, double> > Published;
+
+	boost::shared_ptr<DoubleConflator> Make(boost::asio::io_service &ios, const GPSLib::PublishPolicy &policy, Published &published) {
+		const boost::shared_ptr<DoubleConflator> c(new DoubleConflator(ios, policy));
+		c->Change = [](double published, double value) { return std::fabs(value - published); };
+		c->OnPublish = [&](const std::string &key, double value) { published.push_back(std::make_pair(key, value)); };
+		return c;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ConflatorImmediateTest)
+{
+	// no interval or deadband - everything is published as it arrives
+	boost::asio::io_service ios;
+	Published published;
+	const boost::shared_ptr<DoubleConflator> c(Make(ios, GPSLib::PublishPolicy(), published));
+	c->Add("a", 1.0);
+	c->Add("a", 1.0);
+	c->Add("b", 2.0);
+	BOOST_REQUIRE_EQUAL(3, published.size());
+	BOOST_REQUIRE_EQUAL(3, c->GetPublished());
+	BOOST_REQUIRE_EQUAL(0, c->GetConflated());
+	BOOST_REQUIRE_EQUAL(0, c->GetSuppressed());
+}
+
+BOOST_AUTO_TEST_CASE(ConflatorDeadbandTest)
+{
+	boost::asio::io_service ios;
+	Published published;
+	const boost::shared_ptr<DoubleConflator> c(Make(ios, GPSLib::PublishPolicy(boost::posix_time::time_duration(boost::posix_time::not_a_date_time), 0.5), published));
+	c->Add("a", 1.0);  // the first is always published
+	c->Add("a", 1.3);  // measured from the last published, not the last added
+	c->Add("a", 1.4);
+	c->Add("a", 1.5);
+	c->Add("b", 1.2);  // each key has its own
+	c->Add("a", 1.7);
+	BOOST_REQUIRE_EQUAL(3, published.size());
+	BOOST_REQUIRE_EQUAL("a", published[0].first);
+	BOOST_REQUIRE_EQUAL(1.0, published[0].second);
+	BOOST_REQUIRE_EQUAL(1.5, published[1].second);
+	BOOST_REQUIRE_EQUAL("b", published[2].first);
+	BOOST_REQUIRE_EQUAL(3, c->GetSuppressed());
+}
+
+BOOST_AUTO_TEST_CASE(ConflatorIntervalTest)
+{
+	// only the latest of each key between flushes
+	boost::asio::io_service ios;
+	Published published;
+	const boost::shared_ptr<DoubleConflator> c(Make(ios, GPSLib::PublishPolicy(boost::posix_time::seconds(1)), published));
+	c->Add("a", 1.0);
+	c->Add("a", 2.0);
+	c->Add("b", 3.0);
+	BOOST_REQUIRE_EQUAL(0, published.size());
+	c->Flush();
+	BOOST_REQUIRE_EQUAL(2, published.size());
+	BOOST_REQUIRE_EQUAL("a", published[0].first);
+	BOOST_REQUIRE_EQUAL(2.0, published[0].second);
+	BOOST_REQUIRE_EQUAL("b", published[1].first);
+	BOOST_REQUIRE_EQUAL(3.0, published[1].second);
+	BOOST_REQUIRE_EQUAL(1, c->GetConflated());
+
+	c->Flush();  // nothing new
+	BOOST_REQUIRE_EQUAL(2, published.size());
+}
+
+BOOST_AUTO_TEST_CASE(ConflatorTimerTest)
+{
+	boost::asio::io_service ios;
+	Published published;
+	const boost::shared_ptr<DoubleConflator> c(Make(ios, GPSLib::PublishPolicy(boost::posix_time::milliseconds(10)), published));
+	c->Start();
+	c->Add("a", 1.0);
+	c->Add("a", 2.0);
+	ios.run_one();  // the first tick
+	c->Stop();
+	ios.run();
+	BOOST_REQUIRE_EQUAL(1, published.size());
+	BOOST_REQUIRE_EQUAL(2.0, published[0].second);
+}
+
+BOOST_AUTO_TEST_CASE(AngleBetweenTest)
+{
+	BOOST_REQUIRE_CLOSE(2.0, GPSLib::AngleBetween(359.0, 1.0), 1e-9);
+	BOOST_REQUIRE_CLOSE(2.0, GPSLib::AngleBetween(1.0, 359.0), 1e-9);
+	BOOST_REQUIRE_CLOSE(180.0, GPSLib::AngleBetween(90.0, 270.0), 1e-9);
+	BOOST_REQUIRE_CLOSE(45.5, GPSLib::AngleBetween(10.0, 55.5), 1e-9);
+	BOOST_REQUIRE_EQUAL(0.0, GPSLib::AngleBetween(56.21, 56.21));
+}
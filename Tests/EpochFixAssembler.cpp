@@ -0,0 +1,136 @@
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/bind.hpp>
+#include "../GPSLib/GPSSentenceDecoder.h"
+#include "../GPSLib/EpochFixAssembler.h"
+
+namespace {
+	void Connect(const boost::shared_ptr<GPSLib::GPSSentenceDecoder> &d, const boost::shared_ptr<GPSLib::EpochFixAssembler> &a) {
+		d->OnGGA = boost::bind(&GPSLib::EpochFixAssembler::AddGGA, a, _1, _2, _3, _4, _5, _6, _7, _8);
+		d->OnRMC = boost::bind(&GPSLib::EpochFixAssembler::AddRMC, a, _1, _2, _3, _4, _5, _6, _7, _8);
+		d->OnGSA = boost::bind(&GPSLib::EpochFixAssembler::AddGSA, a, _1, _2, _3, _4, _5, _6, _7);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(EpochFixTest)
+{
+	const std::string s(
+		"$GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*48\r\n"
+		"$GPGLL,3848.2905,N,09018.4239,W,191630.609,A*20\r\n"
+		"$GPGSA,A,3,18,15,29,21,06,09,,,,,,,2.2,1.3,1.8*33\r\n"
+		"$GPGSV,3,1,10,18,62,311,37,15,47,49,40,14,16,218,30,29,11,186,28*4A\r\n"
+		"$GPRMC,191630.609,A,3848.2905,N,09018.4239,W,31.464734,56.21,150113,,*14\r\n");
+	boost::asio::io_service ios;
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);  // so shared_from_this() will work
+	const boost::shared_ptr<GPSLib::EpochFixAssembler> a(new GPSLib::EpochFixAssembler(ios));
+	Connect(d, a);
+
+	int onFixCount = 0;
+	a->OnFix = [&](boost::asio::io_service &ios, const GPSLib::EpochFix &fix) {
+		onFixCount++;
+		BOOST_REQUIRE_EQUAL(GPSLib::SM_GGA | GPSLib::SM_RMC | GPSLib::SM_GSA, fix._sentences);
+		BOOST_REQUIRE_EQUAL(boost::posix_time::duration_from_string("19:16:30.609"), fix._time);
+		BOOST_REQUIRE_EQUAL(boost::gregorian::date(2013, 1, 15), fix._date);
+		BOOST_REQUIRE_CLOSE(38 +(48.2905/60.0), fix._latitude, 0.01);
+		BOOST_REQUIRE_CLOSE(- (90 + (18.4239/60.0)), fix._longitude, 0.01);
+		BOOST_REQUIRE_CLOSE(132.0, fix._altitude, 0.01);
+		BOOST_REQUIRE_CLOSE(31.464734, fix._speed, 0.01);
+		BOOST_REQUIRE_CLOSE(56.21, fix._course, 0.01);
+		BOOST_REQUIRE_CLOSE(2.2, fix._pdop, 0.01);
+		BOOST_REQUIRE_CLOSE(1.3, fix._hdop, 0.01);
+		BOOST_REQUIRE_CLOSE(1.8, fix._vdop, 0.01);
+		BOOST_REQUIRE_EQUAL(1, fix._quality);
+		BOOST_REQUIRE_EQUAL(6, fix._numSatellites);
+		BOOST_REQUIRE_EQUAL(3, fix._fixMode);
+		BOOST_REQUIRE_EQUAL(6, fix._activeSatellites.size());
+		BOOST_REQUIRE(fix._valid);
+	};
+
+	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
+	ios.run();
+
+	BOOST_REQUIRE_EQUAL(1, onFixCount);
+	BOOST_REQUIRE_EQUAL(1, a->GetCompleteFixes());
+	BOOST_REQUIRE_EQUAL(0, a->GetIncompleteFixes());
+}
+
+// an epoch missing a required sentence is emitted incomplete when the next epoch starts, or when flushed
+BOOST_AUTO_TEST_CASE(IncompleteEpochFixTest)
+{
+	const std::string s(
+		"$GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*48\r\n"
+		"$GPRMC,191632.609,A,3848.3005,N,09018.4051,W,32.523475,55.89,150113,,*14\r\n");
+	boost::asio::io_service ios;
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);  // so shared_from_this() will work
+	const boost::shared_ptr<GPSLib::EpochFixAssembler> a(new GPSLib::EpochFixAssembler(ios, GPSLib::SM_GGA | GPSLib::SM_RMC, boost::posix_time::not_a_date_time));
+	Connect(d, a);
+
+	std::vector<unsigned int> sentences;
+	a->OnFix = [&](boost::asio::io_service &ios, const GPSLib::EpochFix &fix) {
+		sentences.push_back(fix._sentences);
+	};
+
+	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
+	ios.run();
+	a->Flush(ios);
+
+	BOOST_REQUIRE_EQUAL(2, sentences.size());
+	BOOST_REQUIRE_EQUAL(GPSLib::SM_GGA, sentences[0]);
+	BOOST_REQUIRE_EQUAL(GPSLib::SM_RMC, sentences[1]);
+	BOOST_REQUIRE_EQUAL(0, a->GetCompleteFixes());
+	BOOST_REQUIRE_EQUAL(2, a->GetIncompleteFixes());
+}
+
+// a superseded epoch keeps the time its own sentence was read, not the time of the one that superseded it
+BOOST_AUTO_TEST_CASE(EpochFixReceivedTest)
+{
+	const std::string s1("$GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*48\r\n");
+	const std::string s2("$GPRMC,191632.609,A,3848.3005,N,09018.4051,W,32.523475,55.89,150113,,*14\r\n");
+	boost::asio::io_service ios;
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);  // so shared_from_this() will work
+	const boost::shared_ptr<GPSLib::EpochFixAssembler> a(new GPSLib::EpochFixAssembler(ios, GPSLib::SM_GGA | GPSLib::SM_RMC, boost::posix_time::not_a_date_time));
+	Connect(d, a);
+
+	const boost::posix_time::ptime t1(boost::gregorian::date(2013, 1, 15), boost::posix_time::seconds(1));
+	const boost::posix_time::ptime t2(t1 + boost::posix_time::seconds(2));
+	boost::posix_time::ptime now = t1;
+	a->Now = [&]() { return now; };
+
+	std::vector<boost::posix_time::ptime> received;
+	a->OnFix = [&](boost::asio::io_service &ios, const GPSLib::EpochFix &fix) {
+		received.push_back(fix._received);
+	};
+
+	d->AddBytes(ios, std::vector<unsigned char>(s1.begin(), s1.end()));
+	ios.run();
+	ios.reset();
+	now = t2;
+	d->AddBytes(ios, std::vector<unsigned char>(s2.begin(), s2.end()));
+	ios.run();
+	a->Flush(ios);
+
+	BOOST_REQUIRE_EQUAL(2, received.size());
+	BOOST_REQUIRE(t1 == received[0]);
+	BOOST_REQUIRE(t2 == received[1]);
+}
+
+// an incomplete epoch is emitted once its timeout expires
+BOOST_AUTO_TEST_CASE(EpochFixTimeoutTest)
+{
+	const std::string s("$GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*48\r\n");
+	boost::asio::io_service ios;
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);  // so shared_from_this() will work
+	const boost::shared_ptr<GPSLib::EpochFixAssembler> a(new GPSLib::EpochFixAssembler(ios, GPSLib::SM_GGA | GPSLib::SM_RMC, boost::posix_time::milliseconds(10)));
+	Connect(d, a);
+
+	int onFixCount = 0;
+	a->OnFix = [&](boost::asio::io_service &ios, const GPSLib::EpochFix &fix) {
+		onFixCount++;
+		BOOST_REQUIRE_EQUAL(GPSLib::SM_GGA, fix._sentences);
+	};
+
+	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
+	ios.run();  // returns once the timeout has fired
+
+	BOOST_REQUIRE_EQUAL(1, onFixCount);
+	BOOST_REQUIRE_EQUAL(1, a->GetIncompleteFixes());
+}
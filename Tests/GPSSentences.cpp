@@ -8,6 +8,7 @@
 #include <fstream>
 #include "../GPSLib/GPSSentenceDecoder.h"
 #include "../GPSLib/Util.h"
+#include "../GPSLib/NMEAGenerator.h"
 
 /* 
 BAD DATA (receiver still initializing):
@@ -243,10 +244,11 @@ BOOST_AUTO_TEST_CASE(UninitializedGLLTest)
 	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
 	ios.run();
 
-	// ensure proper callback was called (if callback not called, test still would have passed)
-	BOOST_REQUIRE(!onInvalidSentenceCalled);
+	// the 360 and 720 degrees of a receiver with no fix yet are out of range, so it is rejected
+	BOOST_REQUIRE(onInvalidSentenceCalled);
+	BOOST_REQUIRE_EQUAL(1, d->GetRejected(GPSLib::RR_BAD_FIELD));
 	BOOST_REQUIRE(!onGGACalled); 
-	BOOST_REQUIRE(onGLLCalled); 
+	BOOST_REQUIRE(!onGLLCalled); 
 	BOOST_REQUIRE(!onRMCCalled); 
 	BOOST_REQUIRE(!onGSVCalled);
 	BOOST_REQUIRE(!onGSACalled);
@@ -295,11 +297,12 @@ BOOST_AUTO_TEST_CASE(UninitializedRMCTest)
 	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
 	ios.run();
 
-	// ensure proper callback was called (if callback not called, test still would have passed)
-	BOOST_REQUIRE(!onInvalidSentenceCalled);
+	// the 360 and 720 degrees of a receiver with no fix yet are out of range, so it is rejected
+	BOOST_REQUIRE(onInvalidSentenceCalled);
+	BOOST_REQUIRE_EQUAL(1, d->GetRejected(GPSLib::RR_BAD_FIELD));
 	BOOST_REQUIRE(!onGGACalled); 
 	BOOST_REQUIRE(!onGLLCalled); 
-	BOOST_REQUIRE(onRMCCalled); 
+	BOOST_REQUIRE(!onRMCCalled); 
 	BOOST_REQUIRE(!onGSVCalled);
 	BOOST_REQUIRE(!onGSACalled);
 }
@@ -580,6 +583,113 @@ BOOST_AUTO_TEST_CASE(GSVTest)
 
 
 
+// sentences not in the mask are dropped - not decoded and not reported as invalid
+BOOST_AUTO_TEST_CASE(SentenceMaskTest)
+{
+	const std::string s(
+		"$GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*48\r\n"
+		"$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*FF\r\n"  // bad checksum, but dropped before the checksum is checked
+		"$GPRMC,191630.609,A,3848.2905,N,09018.4239,W,31.464734,56.21,150113,,*14\r\n");
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder(GPSLib::SM_RMC));  // so shared_from_this() will work  
+	
+	bool onInvalidSentenceCalled = false, onGGACalled = false, onRMCCalled = false, onGSACalled = false;
+	d->OnInvalidSentence = [&](boost::asio::io_service &ios, const std::string &s) {
+		onInvalidSentenceCalled = true;
+	};
+	d->OnGGA = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude, int quality, 
+		int numSatellites, double horizontalDilution, double altitude) {
+		onGGACalled = true;
+	};
+	d->OnRMC = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude,
+		double speed, double course, boost::gregorian::date date, const std::string &validity) {
+		onRMCCalled = true;
+		BOOST_REQUIRE_EQUAL(boost::posix_time::duration_from_string("19:16:30.609"), time);
+		BOOST_REQUIRE_EQUAL("A", validity);
+	};
+	d->OnGSA = [&](boost::asio::io_service &ios, const std::string &mode, int fix, const std::vector<int> &satellitesInView, double pdop, double hdop, double vdop) {
+		onGSACalled = true;
+	};
+
+	boost::asio::io_service ios;
+	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
+	ios.run();
+
+	BOOST_REQUIRE(!onInvalidSentenceCalled);
+	BOOST_REQUIRE(!onGGACalled); 
+	BOOST_REQUIRE(onRMCCalled); 
+	BOOST_REQUIRE(!onGSACalled);
+}
+
+
+// the mask can follow the handlers - sentences without a handler are dropped, unknown sentences are still invalid
+BOOST_AUTO_TEST_CASE(InstalledHandlersMaskTest)
+{
+	const std::string s1("$GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*FF\r\n$GPG");
+	const std::string s2("SV,3,1,10,18,62,311,37,15,47,49,40,14,16,218,30,29,11,186,28*4A\r\n$not a valid sentence\r\n");
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder(GPSLib::SM_INSTALLED_HANDLERS));  // so shared_from_this() will work  
+	
+	int onInvalidSentenceCount = 0, onGSVCount = 0;
+	d->OnInvalidSentence = [&](boost::asio::io_service &ios, const std::string &s) {
+		onInvalidSentenceCount++;
+		BOOST_REQUIRE_EQUAL("$not a valid sentence\r\n", s);
+	};
+	d->OnGSV = [&](boost::asio::io_service &ios, int totalMessages, int messageNumber, int totalSatellitesInView, const std::vector<GPSLib::SatelliteInfo> &satelliteInfo) {
+		onGSVCount++;
+		BOOST_REQUIRE_EQUAL(4, satelliteInfo.size());
+	};
+
+	boost::asio::io_service ios;
+	d->AddBytes(ios, std::vector<unsigned char>(s1.begin(), s1.end()));
+	d->AddBytes(ios, std::vector<unsigned char>(s2.begin(), s2.end()));
+	ios.run();
+
+	BOOST_REQUIRE_EQUAL(1, onInvalidSentenceCount);
+	BOOST_REQUIRE_EQUAL(1, onGSVCount);
+}
+
+
+
+// a consumer of the lazy view only converts the fields it asks for, and the full decode is skipped without a handler
+BOOST_AUTO_TEST_CASE(OnSentenceTest)
+{
+	const std::string s(
+		"$GPGGA,000004.000,0000.0000,N,00000.0000,E,0,00,50.0,0.0,M,0.0,M,0.0,0000*72\r\n"
+		"$GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*48\r\n"
+		"$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*05\r\n");
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder(GPSLib::SM_INSTALLED_HANDLERS));  // so shared_from_this() will work  
+	
+	bool onInvalidSentenceCalled = false;
+	int onSentenceCount = 0, validGGACount = 0, onGSACount = 0;
+	d->OnInvalidSentence = [&](boost::asio::io_service &ios, const std::string &s) {
+		onInvalidSentenceCalled = true;
+	};
+	d->OnSentence = [&](boost::asio::io_service &ios, const GPSLib::SentenceView &view) {
+		onSentenceCount++;
+		int quality;
+		if ((view.GetType() != GPSLib::SM_GGA) || !view.GetInt(GPSLib::GGAFields::Quality, quality) || (quality == 0))
+			return;
+		validGGACount++;
+		double latitude;
+		BOOST_REQUIRE(view.GetLatLng(GPSLib::GGAFields::Latitude, latitude));
+		BOOST_REQUIRE_CLOSE(38 +(48.2905/60.0), latitude, 0.01);
+	};
+	d->OnGSA = [&](boost::asio::io_service &ios, const std::string &mode, int fix, const std::vector<int> &satellitesInView, double pdop, double hdop, double vdop) {
+		onGSACount++;
+		BOOST_REQUIRE_EQUAL("A", mode);
+	};
+
+	boost::asio::io_service ios;
+	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
+	ios.run();
+
+	BOOST_REQUIRE(!onInvalidSentenceCalled);
+	BOOST_REQUIRE_EQUAL(3, onSentenceCount);
+	BOOST_REQUIRE_EQUAL(1, validGGACount);
+	BOOST_REQUIRE_EQUAL(1, onGSACount);
+}
+
+
+
 BOOST_AUTO_TEST_CASE(AllSentencesTest)
 {
 	// read from GPS file, deserialize, pass to decoder, and output all invalid sentences found
@@ -593,6 +703,29 @@ BOOST_AUTO_TEST_CASE(AllSentencesTest)
 		onInvalidSentenceCalled = true;
 	};
 
+	// install every handler, so every sentence is fully decoded as well as being seen through the lazy view
+	int numSentences = 0, numDecoded = 0;
+	d->OnSentence = [&](boost::asio::io_service &ios, const GPSLib::SentenceView &view) {
+		numSentences++;
+	};
+	d->OnGGA = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude, int quality, 
+		int numSatellites, double horizontalDilution, double altitude) {
+		numDecoded++;
+	};
+	d->OnGLL = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude, const std::string &validity) {
+		numDecoded++;
+	};
+	d->OnRMC = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude,
+		double speed, double course, boost::gregorian::date date, const std::string &validity) {
+		numDecoded++;
+	};
+	d->OnGSV = [&](boost::asio::io_service &ios, int totalMessages, int messageNumber, int totalSatellitesInView, const std::vector<GPSLib::SatelliteInfo> &satelliteInfo) {
+		numDecoded++;
+	};
+	d->OnGSA = [&](boost::asio::io_service &ios, const std::string &mode, int fix, const std::vector<int> &satellitesInView, double pdop, double hdop, double vdop) {
+		numDecoded++;
+	};
+
 	// int argc = boost::unit_test::framework::master_test_suite().argc;
 	char **argv = boost::unit_test::framework::master_test_suite().argv;
 
@@ -620,4 +753,77 @@ BOOST_AUTO_TEST_CASE(AllSentencesTest)
 
 	ios.run();
 	BOOST_REQUIRE(!onInvalidSentenceCalled);
+	BOOST_REQUIRE(numSentences > 0);
+	BOOST_REQUIRE_EQUAL(numSentences, numDecoded);
+}
+
+
+BOOST_AUTO_TEST_CASE(CorruptedStreamTest)
+{
+	// each way a line can go wrong is counted, nothing throws, and the good sentences around them still decode
+	const std::string gga("$GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*48\r\n");
+	std::string s(gga);
+	s += GPSLib::NMEAGenerator::MakeSentence("GPGGA,19xx30.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000");  // malformed, with a good checksum
+	s += "$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*FF\r\n";  // bad checksum
+	s += std::string(500, 'x') + "\r\n";  // line noise with no $, longer than any sentence
+	s += gga;
+	s += "$GPGGA,191630.609,3848.29";  // cut short by the next
+	s += gga;
+	s += "$GPXXX,1,2,3\r\n";  // unknown type
+	s += gga;
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);  // so shared_from_this() will work  
+
+	int numGGA = 0, numInvalid = 0;
+	d->OnInvalidSentence = [&](boost::asio::io_service &ios, const std::string &s) {
+		numInvalid++;
+	};
+	d->OnGGA = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double latitude, double longitude, int quality, 
+		int numSatellites, double horizontalDilution, double altitude) {
+		numGGA++;
+	};
+
+	boost::asio::io_service ios;
+	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
+	ios.run();
+
+	BOOST_REQUIRE_EQUAL(4, numGGA);
+	BOOST_REQUIRE_EQUAL(3, numInvalid);  // complete lines only
+	BOOST_REQUIRE_EQUAL(1, d->GetRejected(GPSLib::RR_BAD_FIELD));
+	BOOST_REQUIRE_EQUAL(1, d->GetRejected(GPSLib::RR_CHECKSUM));
+	BOOST_REQUIRE_EQUAL(1, d->GetRejected(GPSLib::RR_TOO_LONG));
+	BOOST_REQUIRE_EQUAL(1, d->GetRejected(GPSLib::RR_TRUNCATED));
+	BOOST_REQUIRE_EQUAL(1, d->GetRejected(GPSLib::RR_UNKNOWN_TYPE));
+	BOOST_REQUIRE_EQUAL(0, d->GetRejected(GPSLib::RR_FRAMING));
+}
+
+
+BOOST_AUTO_TEST_CASE(UTCMillisecondsTest)
+{
+	// times are put on the date of the most recent RMC, including across midnight ahead of the next day's RMC
+	const std::string s(
+		"$GPGGA,235959.000,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*4A\r\n"
+		"$GPRMC,235959.000,A,3848.2905,N,09018.4239,W,31.464734,56.21,311213,,*12\r\n"
+		"$GPGGA,000000.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*44\r\n");
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);  // so shared_from_this() will work  
+
+	const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+	std::vector<bool> haveUTC;
+	std::vector<boost::int64_t> utc;
+	d->OnSentence = [&](boost::asio::io_service &ios, const GPSLib::SentenceView &view) {
+		boost::int64_t value = 0;
+		const size_t timeField = (view.GetType() == GPSLib::SM_RMC) ? static_cast<size_t>(GPSLib::RMCFields::Time) : static_cast<size_t>(GPSLib::GGAFields::Time);
+		haveUTC.push_back(d->GetUTCMilliseconds(view, timeField, value));
+		utc.push_back(value);
+	};
+
+	boost::asio::io_service ios;
+	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
+	ios.run();
+
+	BOOST_REQUIRE_EQUAL(3, utc.size());
+	BOOST_REQUIRE(!haveUTC[0]);  // no date yet
+	BOOST_REQUIRE(haveUTC[1]);
+	BOOST_REQUIRE_EQUAL((boost::posix_time::ptime(boost::gregorian::date(2013, 12, 31), boost::posix_time::duration_from_string("23:59:59.000")) - epoch).total_milliseconds(), utc[1]);
+	BOOST_REQUIRE(haveUTC[2]);
+	BOOST_REQUIRE_EQUAL((boost::posix_time::ptime(boost::gregorian::date(2014, 1, 1), boost::posix_time::duration_from_string("00:00:00.609")) - epoch).total_milliseconds(), utc[2]);
 }
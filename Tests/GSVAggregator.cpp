@@ -0,0 +1,59 @@
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/bind.hpp>
+#include "../GPSLib/GSVAggregator.h"
+
+namespace {
+	const std::string gsv1("$GPGSV,3,1,10,18,62,311,37,15,47,49,40,14,16,218,30,29,11,186,28*4A\r\n");
+	const std::string gsv2("$GPGSV,3,2,10,21,85,224,36,24,34,120,25,23,48,50,0,6,24,295,33*45\r\n");
+	const std::string gsv3("$GPGSV,3,3,10,9,34,86,36,137,0,0,0*48\r\n");
+}
+
+BOOST_AUTO_TEST_CASE(GSVAggregatorTest)
+{
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);  // so shared_from_this() will work
+	GPSLib::GSVAggregator aggregator;
+	d->OnGSV = boost::bind(&GPSLib::GSVAggregator::Add, &aggregator, _1, _2, _3, _4, _5);
+
+	int onSatellitesInViewCount = 0;
+	aggregator.OnSatellitesInView = [&](boost::asio::io_service &ios, int totalSatellitesInView, const std::vector<GPSLib::SatelliteInfo> &satelliteInfo) {
+		onSatellitesInViewCount++;
+		BOOST_REQUIRE_EQUAL(10, totalSatellitesInView);
+		BOOST_REQUIRE_EQUAL(10, satelliteInfo.size());
+		BOOST_REQUIRE_EQUAL(18, satelliteInfo[0]._prn);
+		BOOST_REQUIRE_EQUAL(21, satelliteInfo[4]._prn);
+		BOOST_REQUIRE_EQUAL(85, satelliteInfo[4]._elevation);
+		BOOST_REQUIRE_EQUAL(137, satelliteInfo[9]._prn);
+	};
+
+	const std::string s(gsv1 + gsv2 + gsv3 + gsv1 + gsv2 + gsv3);
+	boost::asio::io_service ios;
+	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
+	ios.run();
+
+	BOOST_REQUIRE_EQUAL(2, onSatellitesInViewCount);
+	BOOST_REQUIRE_EQUAL(2, aggregator.GetCompleteSequences());
+	BOOST_REQUIRE_EQUAL(0, aggregator.GetDiscardedSequences());
+}
+
+BOOST_AUTO_TEST_CASE(GSVAggregatorDiscardTest)
+{
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);  // so shared_from_this() will work
+	GPSLib::GSVAggregator aggregator;
+	d->OnGSV = boost::bind(&GPSLib::GSVAggregator::Add, &aggregator, _1, _2, _3, _4, _5);
+
+	int onSatellitesInViewCount = 0;
+	aggregator.OnSatellitesInView = [&](boost::asio::io_service &ios, int totalSatellitesInView, const std::vector<GPSLib::SatelliteInfo> &satelliteInfo) {
+		onSatellitesInViewCount++;
+		BOOST_REQUIRE_EQUAL(10, satelliteInfo.size());
+	};
+
+	// missing fragment, then a sequence that starts part way through, then out of order, then a good one
+	const std::string s(gsv1 + gsv3 + gsv2 + gsv3 + gsv1 + gsv3 + gsv2 + gsv1 + gsv2 + gsv3);
+	boost::asio::io_service ios;
+	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
+	ios.run();
+
+	BOOST_REQUIRE_EQUAL(1, onSatellitesInViewCount);
+	BOOST_REQUIRE_EQUAL(1, aggregator.GetCompleteSequences());
+	BOOST_REQUIRE_EQUAL(2, aggregator.GetDiscardedSequences());
+}
@@ -0,0 +1,128 @@
+#include <boost/test/auto_unit_test.hpp>
+#include <vector>
+#include "../GPSLib/Geodesy.h"
+#include "../GPSLib/Util.h"
+
+namespace {
+	// a winding track of fixes, about 10m apart
+	void MakeTrack(size_t count, std::vector<double> &lat, std::vector<double> &lon, std::vector<double> &height) {
+		lat.resize(count);
+		lon.resize(count);
+		height.resize(count);
+		for (size_t i = 0; i < count; i++) {
+			lat[i] = 38.8048 + i * 0.00009 * std::cos(i * 0.01);
+			lon[i] = -90.3070 + i * 0.00009 * std::sin(i * 0.01);
+			height[i] = 132.0 + (i % 50);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(NMEAToDecimalDegreesTest)
+{
+	const double ddmm[] = { 3848.2905, 9018.4239, 5130.0, 0.0 };
+	const char hemispheres[] = { 'N', 'W', 'S', 'E' };
+	double decimalDegrees[4];
+	GPSLib::NMEAToDecimalDegrees(ddmm, hemispheres, decimalDegrees, 4);
+	BOOST_REQUIRE_CLOSE(38.804841667, decimalDegrees[0], 1e-7);
+	BOOST_REQUIRE_CLOSE(-90.307065, decimalDegrees[1], 1e-7);
+	BOOST_REQUIRE_CLOSE(-51.5, decimalDegrees[2], 1e-7);
+	BOOST_REQUIRE_EQUAL(0.0, decimalDegrees[3]);
+	for (size_t i = 0; i < 4; i++)
+		BOOST_REQUIRE_CLOSE(GPSLib::NMEAToDecimalDegree(ddmm[i], hemispheres[i]), decimalDegrees[i], 1e-9);
+	BOOST_REQUIRE_EQUAL(GPSLib::ToDecimalDegree(90, 18.4239, 'W'), GPSLib::ToDecimalDegree(90, 18.4239, "W"));
+}
+
+BOOST_AUTO_TEST_CASE(BatchDegreesMinutesSecondsTest)
+{
+	std::vector<double> lat, lon, height;
+	MakeTrack(1000, lat, lon, height);
+	std::vector<int> degrees(lat.size()), minutes(lat.size()), seconds(lat.size());
+	GPSLib::ToDegreesMinutesSeconds(&lon[0], &degrees[0], &minutes[0], &seconds[0], lon.size());
+	for (size_t i = 0; i < lon.size(); i++) {
+		int d, m, s;
+		GPSLib::ToDegreesMinutesSeconds(lon[i], d, m, s);
+		BOOST_REQUIRE_EQUAL(d, degrees[i]);
+		BOOST_REQUIRE_EQUAL(m, minutes[i]);
+		BOOST_REQUIRE_EQUAL(s, seconds[i]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(DistanceAndBearingTest)
+{
+	// Flinders Peak to Buninyong, the worked example in Vincenty's paper
+	const double lat1 = GPSLib::ToDecimalDegree(37, 57, 3.72030, "S"), lon1 = GPSLib::ToDecimalDegree(144, 25, 29.52440, "E");
+	const double lat2 = GPSLib::ToDecimalDegree(37, 39, 10.15610, "S"), lon2 = GPSLib::ToDecimalDegree(143, 55, 35.38390, "E");
+	double distance, bearing;
+	BOOST_REQUIRE(GPSLib::VincentyInverse(lat1, lon1, lat2, lon2, distance, bearing));
+	BOOST_REQUIRE_SMALL(distance - 54972.271, 0.001);
+	BOOST_REQUIRE_CLOSE(GPSLib::ToDecimalDegree(306, 52, 5.37, "E"), bearing, 1e-5);
+
+	BOOST_REQUIRE_CLOSE(distance, GPSLib::HaversineDistance(lat1, lon1, lat2, lon2), 0.5);
+	BOOST_REQUIRE_CLOSE(bearing, GPSLib::InitialBearing(lat1, lon1, lat2, lon2), 0.1);
+
+	BOOST_REQUIRE(GPSLib::VincentyInverse(lat1, lon1, lat1, lon1, distance, bearing));
+	BOOST_REQUIRE_EQUAL(0.0, distance);
+	// nearly antipodal points don't converge
+	BOOST_REQUIRE(!GPSLib::VincentyInverse(0, 0, 0.5, 179.7, distance, bearing));
+}
+
+BOOST_AUTO_TEST_CASE(BatchDistanceAndBearingTest)
+{
+	std::vector<double> lat, lon, height;
+	MakeTrack(1000, lat, lon, height);
+	const size_t legs = lat.size() - 1;
+	std::vector<double> haversine(legs), track(legs), bearings(legs), vincenty(legs), vincentyBearings(legs);
+	GPSLib::HaversineDistances(&lat[0], &lon[0], &lat[1], &lon[1], &haversine[0], legs);
+	GPSLib::TrackDistances(&lat[0], &lon[0], &track[0], lat.size());
+	GPSLib::InitialBearings(&lat[0], &lon[0], &lat[1], &lon[1], &bearings[0], legs);
+	BOOST_REQUIRE_EQUAL(0, GPSLib::VincentyInverse(&lat[0], &lon[0], &lat[1], &lon[1], &vincenty[0], &vincentyBearings[0], legs));
+	for (size_t i = 0; i < legs; i++) {
+		BOOST_REQUIRE_CLOSE(GPSLib::HaversineDistance(lat[i], lon[i], lat[i+1], lon[i+1]), haversine[i], 1e-9);
+		BOOST_REQUIRE_CLOSE(haversine[i], track[i], 1e-9);
+		BOOST_REQUIRE_CLOSE(GPSLib::InitialBearing(lat[i], lon[i], lat[i+1], lon[i+1]), bearings[i], 1e-9);
+		double distance, bearing;
+		GPSLib::VincentyInverse(lat[i], lon[i], lat[i+1], lon[i+1], distance, bearing);
+		BOOST_REQUIRE_EQUAL(distance, vincenty[i]);
+		BOOST_REQUIRE_EQUAL(bearing, vincentyBearings[i]);
+		BOOST_REQUIRE_CLOSE(vincenty[i], haversine[i], 0.5);
+	}
+
+	double distance = 0, bearing = 0;
+	const double antipodes[] = { 0, 0, 0.5, 179.7 };
+	BOOST_REQUIRE_EQUAL(1, GPSLib::VincentyInverse(&antipodes[0], &antipodes[1], &antipodes[2], &antipodes[3], &distance, &bearing, 1));
+	BOOST_REQUIRE(distance != distance);  // NaN
+}
+
+BOOST_AUTO_TEST_CASE(ECEFAndENUTest)
+{
+	double x, y, z;
+	GPSLib::GeodeticToECEF(0, 0, 0, x, y, z);
+	BOOST_REQUIRE_CLOSE(GPSLib::WGS84::SemiMajorAxis, x, 1e-9);
+	BOOST_REQUIRE_SMALL(y, 1e-6);
+	BOOST_REQUIRE_SMALL(z, 1e-6);
+	GPSLib::GeodeticToECEF(90, 0, 100, x, y, z);
+	BOOST_REQUIRE_CLOSE(GPSLib::WGS84::SemiMinorAxis + 100, z, 1e-9);
+
+	// a point due north and above the reference
+	double east, north, up;
+	GPSLib::GeodeticToENU(38.8148, -90.3070, 142.0, 38.8048, -90.3070, 132.0, east, north, up);
+	BOOST_REQUIRE_SMALL(east, 1e-6);
+	BOOST_REQUIRE_CLOSE(1110.0, north, 0.5);
+	BOOST_REQUIRE_SMALL(up - 10.0, 0.2);  // less the earth's curvature over a kilometer
+
+	std::vector<double> lat, lon, height;
+	MakeTrack(1000, lat, lon, height);
+	std::vector<double> xs(lat.size()), ys(lat.size()), zs(lat.size()), easts(lat.size()), norths(lat.size()), ups(lat.size());
+	GPSLib::GeodeticToECEF(&lat[0], &lon[0], &height[0], &xs[0], &ys[0], &zs[0], lat.size());
+	GPSLib::GeodeticToENU(&lat[0], &lon[0], &height[0], lat[0], lon[0], height[0], &easts[0], &norths[0], &ups[0], lat.size());
+	for (size_t i = 0; i < lat.size(); i++) {
+		GPSLib::GeodeticToECEF(lat[i], lon[i], height[i], x, y, z);
+		BOOST_REQUIRE_SMALL(x - xs[i], 1e-6);
+		BOOST_REQUIRE_SMALL(y - ys[i], 1e-6);
+		BOOST_REQUIRE_SMALL(z - zs[i], 1e-6);
+		GPSLib::GeodeticToENU(lat[i], lon[i], height[i], lat[0], lon[0], height[0], east, north, up);
+		BOOST_REQUIRE_SMALL(east - easts[i], 1e-6);
+		BOOST_REQUIRE_SMALL(north - norths[i], 1e-6);
+		BOOST_REQUIRE_SMALL(up - ups[i], 1e-6);
+	}
+}
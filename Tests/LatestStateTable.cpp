@@ -0,0 +1,128 @@
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/thread.hpp>
+#include <boost/lexical_cast.hpp>
+#include "../GPSLib/LatestStateTable.h"
+
+BOOST_AUTO_TEST_CASE(LatestStateMergeTest)
+{
+	GPSLib::LatestStateTable table(16);
+	GPSLib::SensorState state;
+	BOOST_REQUIRE(!table.Get("a", state));
+	BOOST_REQUIRE_EQUAL(GPSLib::LatestStateTable::npos, table.Find("a"));
+
+	// each topic updates its own part
+	BOOST_REQUIRE(table.UpdatePosition("a", 1000, 38.8, -90.3));
+	BOOST_REQUIRE(table.UpdateAltitude("a", 1000, 130));
+	BOOST_REQUIRE(table.UpdateCourse("b", 2000, 5, 90));
+	BOOST_REQUIRE(table.UpdatePosition("a", 2000, 38.9, -90.4));
+
+	BOOST_REQUIRE(table.Get("a", state));
+	BOOST_REQUIRE_EQUAL(2000, state._positionDate);
+	BOOST_REQUIRE_EQUAL(38.9, state._latitude);
+	BOOST_REQUIRE_EQUAL(-90.4, state._longitude);
+	BOOST_REQUIRE_EQUAL(1000, state._altitudeDate);
+	BOOST_REQUIRE_EQUAL(130, state._altitude);
+	BOOST_REQUIRE_EQUAL(0, state._courseDate);
+
+	const size_t b = table.Find("b");
+	BOOST_REQUIRE(b != GPSLib::LatestStateTable::npos);
+	table.Get(b, state);
+	BOOST_REQUIRE_EQUAL(90, state._course);
+	BOOST_REQUIRE_EQUAL(0, state._positionDate);
+	BOOST_REQUIRE_EQUAL(2, table.GetSize());
+}
+
+BOOST_AUTO_TEST_CASE(LatestStateOutOfOrderTest)
+{
+	// a part read late from one topic doesn't replace a newer one from another
+	GPSLib::LatestStateTable table(16);
+	BOOST_REQUIRE(table.UpdatePosition("a", 2000, 38.9, -90.4));
+	BOOST_REQUIRE(table.UpdatePosition("a", 1000, 38.8, -90.3));
+	BOOST_REQUIRE(table.UpdateCourse("a", 2000, 5, 90));
+	BOOST_REQUIRE(table.UpdateCourse("a", 1000, 4, 80));
+	BOOST_REQUIRE(table.UpdateAltitude("a", 2000, 130));
+	BOOST_REQUIRE(table.UpdateAltitude("a", 1000, 120));
+
+	GPSLib::SensorState state;
+	BOOST_REQUIRE(table.Get("a", state));
+	BOOST_REQUIRE_EQUAL(2000, state._positionDate);
+	BOOST_REQUIRE_EQUAL(38.9, state._latitude);
+	BOOST_REQUIRE_EQUAL(2000, state._courseDate);
+	BOOST_REQUIRE_EQUAL(90, state._course);
+	BOOST_REQUIRE_EQUAL(2000, state._altitudeDate);
+	BOOST_REQUIRE_EQUAL(130, state._altitude);
+
+	// the same date again is taken
+	BOOST_REQUIRE(table.UpdatePosition("a", 2000, 39.0, -90.5));
+	BOOST_REQUIRE(table.Get("a", state));
+	BOOST_REQUIRE_EQUAL(39.0, state._latitude);
+}
+
+BOOST_AUTO_TEST_CASE(LatestStateCapacityTest)
+{
+	// three quarters of 16
+	GPSLib::LatestStateTable table(16);
+	for (int i = 0; i < 12; i++)
+		BOOST_REQUIRE(table.UpdatePosition(boost::lexical_cast<std::string>(i), i, i, i));
+	BOOST_REQUIRE(!table.UpdatePosition("12", 12, 12, 12));
+	BOOST_REQUIRE(table.UpdatePosition("11", 13, 13, 13));  // already there
+	BOOST_REQUIRE_EQUAL(1, table.GetRefused());
+
+	GPSLib::SensorState state;
+	for (int i = 0; i < 11; i++) {
+		BOOST_REQUIRE(table.Get(boost::lexical_cast<std::string>(i), state));
+		BOOST_REQUIRE_EQUAL(i, state._latitude);
+	}
+	BOOST_REQUIRE(!table.Get("12", state));
+}
+
+BOOST_AUTO_TEST_CASE(LatestStateSmallCapacityTest)
+{
+	// a table sized for one sensor takes it, and a table for however many takes them all
+	GPSLib::LatestStateTable one(GPSLib::LatestStateTable::CapacityFor(1));
+	BOOST_REQUIRE(one.UpdatePosition("a", 1, 1, 1));
+	BOOST_REQUIRE(!one.UpdatePosition("b", 1, 1, 1));
+	BOOST_REQUIRE_EQUAL(1, one.GetRefused());
+
+	GPSLib::LatestStateTable tiny(1);  // still leaves a slot free for lookups of unknown sensors to stop at
+	BOOST_REQUIRE(tiny.UpdatePosition("a", 1, 1, 1));
+	GPSLib::SensorState state;
+	BOOST_REQUIRE(!tiny.Get("b", state));
+
+	for (size_t sensors = 1; sensors <= 50; sensors++) {
+		GPSLib::LatestStateTable table(GPSLib::LatestStateTable::CapacityFor(sensors));
+		for (size_t i = 0; i < sensors; i++)
+			BOOST_REQUIRE(table.UpdatePosition(boost::lexical_cast<std::string>(i), 1, 1, 1));
+		BOOST_REQUIRE_EQUAL(0, table.GetRefused());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(LatestStateThreadsTest)
+{
+	// every state read whole - the writer keeps latitude, longitude and date in step
+	GPSLib::LatestStateTable table;
+	table.UpdatePosition("a", 0, 0, 0);
+	const size_t a = table.Find("a");
+	volatile bool done = false;
+	bool torn = false;
+
+	boost::thread_group readers;
+	for (int t = 0; t < 4; t++)
+		readers.create_thread([&table, a, &done, &torn]() {
+			GPSLib::SensorState state;
+			while (!done) {
+				table.Get(a, state);
+				if ((state._latitude != static_cast<double>(state._positionDate)) || (state._longitude != -state._latitude))
+					torn = true;
+			}
+		});
+	for (int i = 1; i <= 200000; i++)
+		table.UpdatePosition("a", i, i, -i);
+	done = true;
+	readers.join_all();
+
+	BOOST_REQUIRE(!torn);
+	GPSLib::SensorState state;
+	table.Get(a, state);
+	BOOST_REQUIRE_EQUAL(200000, state._positionDate);
+}
@@ -0,0 +1,112 @@
+#include <boost/test/auto_unit_test.hpp>
+#include <map>
+#include "../GPSLib/MultiStreamDecoder.h"
+
+BOOST_AUTO_TEST_CASE(MultiStreamDecoderTest)
+{
+	// sentences from several streams, arriving in pieces and interleaved - each stream must frame on its own
+	const std::string gga("$GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*48\r\n");
+	const std::string gsa("$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*05\r\n");
+	boost::asio::io_service ios;
+	const boost::shared_ptr<GPSLib::MultiStreamDecoder> d(new GPSLib::MultiStreamDecoder(ios, 3));  // so shared_from_this() will work
+	BOOST_REQUIRE_EQUAL(3, d->GetShardCount());
+
+	std::map<unsigned int, int> ggaCount, gsaCount;
+	bool onInvalidSentenceCalled = false;
+	d->OnSentence = [&](boost::asio::io_service &ios, unsigned int streamId, const GPSLib::SentenceView &view) {
+		if (view.GetType() == GPSLib::SM_GGA) {
+			ggaCount[streamId]++;
+			double latitude;
+			BOOST_REQUIRE(view.GetLatLng(GPSLib::GGAFields::Latitude, latitude));
+			BOOST_REQUIRE_CLOSE(38 +(48.2905/60.0), latitude, 0.01);
+		} else if (view.GetType() == GPSLib::SM_GSA)
+			gsaCount[streamId]++;
+	};
+	d->OnInvalidSentence = [&](boost::asio::io_service &ios, unsigned int streamId, const std::string &s) {
+		onInvalidSentenceCalled = true;
+	};
+
+	const unsigned int numStreams = 10;
+	for (size_t split = 0; split < gga.size(); split += 7) {
+		for (unsigned int id = 0; id < numStreams; id++) {
+			const std::string &s = (id % 2) ? gga : gsa;
+			if (split < s.size())
+				d->AddBytes(ios, id, std::vector<unsigned char>(s.begin() + split, s.begin() + std::min(split + 7, s.size())));
+		}
+	}
+	ios.run();
+
+	BOOST_REQUIRE(!onInvalidSentenceCalled);
+	for (unsigned int id = 0; id < numStreams; id++) {
+		BOOST_REQUIRE_EQUAL((id % 2) ? 1 : 0, ggaCount[id]);
+		BOOST_REQUIRE_EQUAL((id % 2) ? 0 : 1, gsaCount[id]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(MultiStreamDecoderRejectTest)
+{
+	// a line too long to be a sentence, one cut short by the next, and one with a bad checksum are all counted
+	std::string s(GPSLib::SentenceFramer::MaxSentenceLength + 10, 'x');
+	s = "$GP" + s + "\r\n";
+	s += "$GPGGA,191630.609,3848.29";
+	s += "$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*06\r\n";
+	boost::asio::io_service ios;
+	const boost::shared_ptr<GPSLib::MultiStreamDecoder> d(new GPSLib::MultiStreamDecoder(ios, 2));  // so shared_from_this() will work
+
+	int invalidCount = 0;
+	d->OnInvalidSentence = [&](boost::asio::io_service &ios, unsigned int streamId, const std::string &s) {
+		invalidCount++;
+	};
+	d->AddBytes(ios, 7, std::vector<unsigned char>(s.begin(), s.end()));
+	ios.run();
+
+	BOOST_REQUIRE_EQUAL(1, invalidCount);  // only the complete line is handed on
+	BOOST_REQUIRE_EQUAL(1, d->GetRejected(GPSLib::RR_TOO_LONG));
+	BOOST_REQUIRE_EQUAL(1, d->GetRejected(GPSLib::RR_TRUNCATED));
+	BOOST_REQUIRE_EQUAL(1, d->GetRejected(GPSLib::RR_CHECKSUM));
+}
+
+BOOST_AUTO_TEST_CASE(SentenceFramerOverflowTest)
+{
+	// a line too long to be a sentence is dropped, and framing resumes at the next $
+	std::string s(GPSLib::SentenceFramer::MaxSentenceLength + 10, 'x');
+	s += "$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*05\r\n";
+	GPSLib::SentenceFramer framer;
+	int complete = 0, tooLong = 0;
+	for (size_t i = 0; i < s.size(); i++)
+		switch (framer.Add(s[i], GPSLib::SM_ALL)) {
+		case GPSLib::SentenceFramer::Complete:
+			complete++;
+			BOOST_REQUIRE_EQUAL("$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*05\r\n", std::string(framer.GetSentence(), framer.GetLength()));
+			break;
+		case GPSLib::SentenceFramer::TooLong:
+			tooLong++;
+			break;
+		default:
+			break;
+		}
+	BOOST_REQUIRE_EQUAL(1, complete);
+	BOOST_REQUIRE_EQUAL(1, tooLong);
+}
+
+BOOST_AUTO_TEST_CASE(SentenceFramerTruncatedTest)
+{
+	// a sentence cut short by the next is dropped, and the next is framed from its $
+	const std::string s("$GPGGA,191630.609,3848.29$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*05\r\n");
+	GPSLib::SentenceFramer framer;
+	int complete = 0, truncated = 0;
+	for (size_t i = 0; i < s.size(); i++)
+		switch (framer.Add(s[i], GPSLib::SM_ALL)) {
+		case GPSLib::SentenceFramer::Complete:
+			complete++;
+			BOOST_REQUIRE_EQUAL("$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*05\r\n", std::string(framer.GetSentence(), framer.GetLength()));
+			break;
+		case GPSLib::SentenceFramer::Truncated:
+			truncated++;
+			break;
+		default:
+			break;
+		}
+	BOOST_REQUIRE_EQUAL(1, complete);
+	BOOST_REQUIRE_EQUAL(1, truncated);
+}
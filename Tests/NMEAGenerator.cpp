@@ -0,0 +1,87 @@
+#include <boost/test/auto_unit_test.hpp>
+#include "../GPSLib/NMEAGenerator.h"
+#include "../GPSLib/GPSSentenceDecoder.h"
+
+BOOST_AUTO_TEST_CASE(MakeSentenceTest)
+{
+	BOOST_REQUIRE_EQUAL("$GPGLL,3848.2905,N,09018.4239,W,191630.609,A*20\r\n", GPSLib::NMEAGenerator::MakeSentence("GPGLL,3848.2905,N,09018.4239,W,191630.609,A"));
+	BOOST_REQUIRE_EQUAL("$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*05\r\n", GPSLib::NMEAGenerator::MakeSentence("GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0"));
+}
+
+BOOST_AUTO_TEST_CASE(NMEAGeneratorTest)
+{
+	// everything generated decodes, and follows the trajectory
+	GPSLib::NMEAGenerator g(38.8048, -90.3070, 30.0, 45.0);
+	g.SetRate(10);
+	const std::string s(g.Generate(100));
+	BOOST_REQUIRE_EQUAL(100 * 7, g.GetSentenceCount());  // GGA, GLL, GSA, 3 GSV and RMC each epoch
+	BOOST_REQUIRE(g.GetLatitude() > 38.8048);
+	BOOST_REQUIRE(g.GetLongitude() > -90.3070);
+
+	boost::asio::io_service ios;
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);  // so shared_from_this() will work
+	int numGGA = 0, numRMC = 0, numGSV = 0, numInvalid = 0;
+	double lastLatitude = 0;
+	boost::posix_time::time_duration lastTime;
+	d->OnGGA = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double lat, double lng, int quality, int numSatellites, double horizontalDilution, double altitude) {
+		if (numGGA++ == 0)
+			BOOST_REQUIRE_CLOSE(38.8048, lat, 0.0001);
+		else {
+			BOOST_REQUIRE(lat > lastLatitude);
+			BOOST_REQUIRE_EQUAL(boost::posix_time::milliseconds(100), time - lastTime);
+		}
+		lastLatitude = lat;
+		lastTime = time;
+		BOOST_REQUIRE_EQUAL(6, numSatellites);
+	};
+	d->OnRMC = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double lat, double lng, double speed, double course, boost::gregorian::date date, const std::string &validity) {
+		numRMC++;
+		BOOST_REQUIRE_CLOSE(30.0, speed, 0.01);
+		BOOST_REQUIRE_CLOSE(45.0, course, 0.01);
+		BOOST_REQUIRE_EQUAL(boost::gregorian::date(2013, 1, 15), date);
+	};
+	d->OnGSV = [&](boost::asio::io_service &ios, int totalMessages, int messageNumber, int totalSatellitesInView, const std::vector<GPSLib::SatelliteInfo> &satelliteInfo) {
+		numGSV++;
+		BOOST_REQUIRE_EQUAL(10, totalSatellitesInView);
+	};
+	d->OnInvalidSentence = [&](boost::asio::io_service &ios, const std::string &s) {
+		numInvalid++;
+	};
+	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
+	ios.run();
+
+	BOOST_REQUIRE_EQUAL(100, numGGA);
+	BOOST_REQUIRE_EQUAL(100, numRMC);
+	BOOST_REQUIRE_EQUAL(300, numGSV);
+	BOOST_REQUIRE_EQUAL(0, numInvalid);
+}
+
+BOOST_AUTO_TEST_CASE(NMEAGeneratorCorruptionTest)
+{
+	// corrupted sentences fail their checksum, and the same seed gives the same stream
+	GPSLib::NMEAGenerator g(38.8048, -90.3070, 30.0, 45.0);
+	g.SetSentences(GPSLib::SM_GGA | GPSLib::SM_RMC);
+	g.SetCorruption(0.25, 0);
+	const std::string s(g.Generate(200));
+
+	GPSLib::NMEAGenerator same(38.8048, -90.3070, 30.0, 45.0);
+	same.SetSentences(GPSLib::SM_GGA | GPSLib::SM_RMC);
+	same.SetCorruption(0.25, 0);
+	BOOST_REQUIRE_EQUAL(s, same.Generate(200));
+
+	boost::asio::io_service ios;
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);  // so shared_from_this() will work
+	int numValid = 0, numInvalid = 0;
+	d->OnSentence = [&](boost::asio::io_service &ios, const GPSLib::SentenceView &view) {
+		numValid++;
+	};
+	d->OnInvalidSentence = [&](boost::asio::io_service &ios, const std::string &s) {
+		numInvalid++;
+	};
+	d->AddBytes(ios, std::vector<unsigned char>(s.begin(), s.end()));
+	ios.run();
+
+	BOOST_REQUIRE_EQUAL(400, numValid + numInvalid);
+	BOOST_REQUIRE(numInvalid > 50);
+	BOOST_REQUIRE(numInvalid < 150);
+}
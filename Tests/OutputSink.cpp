@@ -0,0 +1,75 @@
+#include <boost/test/auto_unit_test.hpp>
+#include <sstream>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include "../ASIOLib/OutputSink.h"
+
+namespace {
+	void WriteNumber(int n, std::ostream &out) {
+		out << n << "\n";
+	}
+}
+
+BOOST_AUTO_TEST_CASE(OutputSinkOrderTest)
+{
+	std::ostringstream out;
+	{
+		ASIOLib::OutputSink sink(out, 16, 8, boost::posix_time::milliseconds(100), ASIOLib::FQ_BLOCK);  // a write every few records
+		BOOST_REQUIRE(sink.SubmitText("a\n"));
+		const unsigned char bytes[] = { 'b', 0, 'c' };
+		BOOST_REQUIRE(sink.SubmitBytes(bytes, sizeof(bytes)));
+		BOOST_REQUIRE(sink.Submit(boost::bind(&WriteNumber, 42, _1)));
+		for (int i = 0; i < 100; i++)
+			sink.Submit(boost::bind(&WriteNumber, i, _1));
+		sink.Stop();
+		BOOST_REQUIRE(!sink.SubmitText("late"));
+	}
+
+	std::ostringstream expected;
+	expected << "a\n" << 'b' << '\0' << 'c' << "42\n";
+	for (int i = 0; i < 100; i++)
+		expected << i << "\n";
+	BOOST_REQUIRE(expected.str() == out.str());
+}
+
+BOOST_AUTO_TEST_CASE(OutputSinkThreadsTest)
+{
+	std::ostringstream out;
+	ASIOLib::OutputSink sink(out, 64, 1024, boost::posix_time::milliseconds(10), ASIOLib::FQ_BLOCK);
+	boost::thread_group threads;
+	for (int t = 0; t < 4; t++)
+		threads.create_thread([&]() {
+			for (int i = 0; i < 1000; i++)
+				sink.SubmitText("line\n");
+		});
+	threads.join_all();
+	sink.Stop();
+
+	BOOST_REQUIRE_EQUAL(0, sink.GetDropped());
+	BOOST_REQUIRE_EQUAL(4000 * 5, out.str().size());
+}
+
+BOOST_AUTO_TEST_CASE(OutputSinkIntervalTest)
+{
+	// written once the interval passes, without waiting for the buffer to fill
+	std::ostringstream out;
+	ASIOLib::OutputSink sink(out, 16, 1024 * 1024, boost::posix_time::milliseconds(10));
+	sink.SubmitText("x");
+	for (int i = 0; (i < 200) && out.str().empty(); i++)
+		boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+	BOOST_REQUIRE_EQUAL("x", out.str());
+}
+
+BOOST_AUTO_TEST_CASE(OutputSinkSteadyIntervalTest)
+{
+	// records arriving faster than the interval are still written out every interval, not held until the buffer fills
+	std::ostringstream out;
+	ASIOLib::OutputSink sink(out, 16, 1024 * 1024, boost::posix_time::milliseconds(50));
+	bool written = false;
+	for (int i = 0; (i < 40) && !written; i++) {
+		sink.SubmitText("x");
+		boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+		written = !out.str().empty();
+	}
+	BOOST_REQUIRE(written);
+}
@@ -0,0 +1,164 @@
+#include <boost/test/auto_unit_test.hpp>
+#include "../GPSLib/SentenceView.h"
+
+namespace {
+	bool Parse(GPSLib::SentenceView &view, const std::string &s) {
+		return view.Parse(s.data(), s.data() + s.size());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(SentenceViewGGATest)
+{
+	const std::string s("$GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*48\r\n");
+	GPSLib::SentenceView view;
+	BOOST_REQUIRE(Parse(view, s));
+	BOOST_REQUIRE_EQUAL(GPSLib::SM_GGA, view.GetType());
+	BOOST_REQUIRE_EQUAL(15, view.GetNumFields());
+	BOOST_REQUIRE(view.Equals(0, "GPGGA"));
+
+	boost::posix_time::time_duration time;
+	BOOST_REQUIRE(view.GetTime(GPSLib::GGAFields::Time, time));
+	BOOST_REQUIRE_EQUAL(boost::posix_time::duration_from_string("19:16:30.609"), time);
+
+	double latitude, longitude, altitude;
+	BOOST_REQUIRE(view.GetLatLng(GPSLib::GGAFields::Latitude, latitude));
+	BOOST_REQUIRE_CLOSE(38 +(48.2905/60.0), latitude, 0.0001);
+	BOOST_REQUIRE(view.GetLatLng(GPSLib::GGAFields::Longitude, longitude));
+	BOOST_REQUIRE_CLOSE(- (90 + (18.4239/60.0)), longitude, 0.0001);
+	BOOST_REQUIRE(view.GetDouble(GPSLib::GGAFields::Altitude, altitude));
+	BOOST_REQUIRE_EQUAL(132.0, altitude);
+
+	int quality, numSatellites;
+	BOOST_REQUIRE(view.GetInt(GPSLib::GGAFields::Quality, quality));
+	BOOST_REQUIRE_EQUAL(1, quality);
+	BOOST_REQUIRE(view.GetInt(GPSLib::GGAFields::NumSatellites, numSatellites));
+	BOOST_REQUIRE_EQUAL(6, numSatellites);
+
+	double geoidSeparation;
+	BOOST_REQUIRE(view.GetDouble(11, geoidSeparation));
+	BOOST_REQUIRE_EQUAL(-33.7, geoidSeparation);
+	std::string lastField;
+	BOOST_REQUIRE(view.GetString(14, lastField));
+	BOOST_REQUIRE_EQUAL("0000", lastField);
+	BOOST_REQUIRE(!view.GetString(15, lastField));
+}
+
+BOOST_AUTO_TEST_CASE(SentenceViewRMCTest)
+{
+	const std::string s("$GPRMC,000003.000,V,36000.0000,N,72000.0000,E,0.000000,,101102,,*3A\r\n");
+	GPSLib::SentenceView view;
+	BOOST_REQUIRE(Parse(view, s));
+	BOOST_REQUIRE_EQUAL(GPSLib::SM_RMC, view.GetType());
+
+	char validity;
+	BOOST_REQUIRE(view.GetChar(GPSLib::RMCFields::Validity, validity));
+	BOOST_REQUIRE_EQUAL('V', validity);
+
+	double latitude, speed, course = -1;
+	BOOST_REQUIRE(!view.GetLatLng(GPSLib::RMCFields::Latitude, latitude));  // 360 degrees, from a receiver with no fix yet
+	BOOST_REQUIRE(view.GetDouble(GPSLib::RMCFields::Speed, speed));
+	BOOST_REQUIRE_EQUAL(0, speed);
+	BOOST_REQUIRE(view.IsEmpty(GPSLib::RMCFields::Course));
+	BOOST_REQUIRE(!view.GetDouble(GPSLib::RMCFields::Course, course));
+	BOOST_REQUIRE_EQUAL(-1, course);  // untouched
+
+	boost::gregorian::date date;
+	BOOST_REQUIRE(view.GetDate(GPSLib::RMCFields::Date, date));
+	BOOST_REQUIRE_EQUAL(boost::gregorian::date(2002, 11, 10), date);
+
+	// the same as integers
+	int millisecondsOfDay, daysSinceEpoch;
+	BOOST_REQUIRE(view.GetTimeOfDay(GPSLib::RMCFields::Time, millisecondsOfDay));
+	BOOST_REQUIRE_EQUAL(3000, millisecondsOfDay);
+	BOOST_REQUIRE(view.GetDaysSinceEpoch(GPSLib::RMCFields::Date, daysSinceEpoch));
+	BOOST_REQUIRE_EQUAL((date - boost::gregorian::date(1970, 1, 1)).days(), daysSinceEpoch);
+}
+
+BOOST_AUTO_TEST_CASE(SentenceViewFixedPointTest)
+{
+	const std::string s("$GPRMC,191630.609,A,3848.2905,N,09018.4239,W,31.464734,56.21,150113,,*14\r\n");
+	GPSLib::SentenceView view;
+	BOOST_REQUIRE(Parse(view, s));
+
+	// to the nearest 1e-7 degree, the same as rounding the double
+	GPSLib::FixedCoordinate latitude, longitude;
+	double latitudeDegrees, longitudeDegrees;
+	BOOST_REQUIRE(view.GetLatLng(GPSLib::RMCFields::Latitude, latitude));
+	BOOST_REQUIRE_EQUAL(388048417, latitude.GetValue());
+	BOOST_REQUIRE(view.GetLatLng(GPSLib::RMCFields::Latitude, latitudeDegrees));
+	BOOST_REQUIRE(GPSLib::FixedCoordinate::FromDegrees(latitudeDegrees) == latitude);
+	BOOST_REQUIRE(view.GetLatLng(GPSLib::RMCFields::Longitude, longitude));
+	BOOST_REQUIRE_EQUAL(-903070650, longitude.GetValue());
+	BOOST_REQUIRE(view.GetLatLng(GPSLib::RMCFields::Longitude, longitudeDegrees));
+	BOOST_REQUIRE(GPSLib::FixedCoordinate::FromDegrees(longitudeDegrees) == longitude);
+	BOOST_REQUIRE_CLOSE(longitudeDegrees, longitude.GetDegrees(), 1e-7);
+
+	boost::int32_t speed, course;
+	BOOST_REQUIRE(view.GetScaled(GPSLib::RMCFields::Speed, 3, speed));
+	BOOST_REQUIRE_EQUAL(31465, speed);  // rounded
+	BOOST_REQUIRE(view.GetScaled(GPSLib::RMCFields::Course, 3, course));
+	BOOST_REQUIRE_EQUAL(56210, course);  // padded
+	BOOST_REQUIRE_EQUAL(GPSLib::ToScaled(56.21, 3), course);
+	BOOST_REQUIRE(view.GetScaled(GPSLib::RMCFields::Course, 0, course));
+	BOOST_REQUIRE_EQUAL(56, course);
+
+	boost::int32_t value = -1;
+	BOOST_REQUIRE(!view.GetScaled(GPSLib::RMCFields::Date + 1, 3, value));  // empty
+	BOOST_REQUIRE(!view.GetScaled(GPSLib::RMCFields::Date, 6, value));  // too large for 32 bits
+	BOOST_REQUIRE_EQUAL(-1, value);  // untouched
+
+	const std::string gga("$GPGGA,1916x0.609,38482905,N,09018.4239,W,one,06,1..3,-33.7,M,-33.7,M,0.0,0000*4C\r\n");
+	BOOST_REQUIRE(Parse(view, gga));
+	BOOST_REQUIRE(!view.GetLatLng(GPSLib::GGAFields::Latitude, latitude));
+	BOOST_REQUIRE(!view.GetScaled(GPSLib::GGAFields::HorizontalDilution, 1, value));
+	BOOST_REQUIRE(view.GetScaled(GPSLib::GGAFields::Altitude, 3, value));
+	BOOST_REQUIRE_EQUAL(-33700, value);
+}
+
+BOOST_AUTO_TEST_CASE(SentenceViewInvalidTest)
+{
+	GPSLib::SentenceView view;
+	BOOST_REQUIRE(!Parse(view, "$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*FF\r\n"));  // checksum mismatch
+	BOOST_REQUIRE(!Parse(view, "$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*0G\r\n"));  // checksum not hex
+	BOOST_REQUIRE(!Parse(view, "$GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*05"));  // no CRLF
+	BOOST_REQUIRE(!Parse(view, "GPGSA,A,1,,,,,,,,,,,,,50.0,50.0,50.0*05\r\n"));  // no $
+	BOOST_REQUIRE(Parse(view, "$not a valid sentence\r\n"));  // no checksum to check, and not a sentence that can be decoded
+	BOOST_REQUIRE_EQUAL(GPSLib::SM_NONE, view.GetType());
+}
+
+BOOST_AUTO_TEST_CASE(SentenceViewMalformedFieldTest)
+{
+	// valid checksum, but fields that don't convert
+	const std::string s("$GPGGA,1916x0.609,38482905,N,09018.4239,W,one,06,1..3,132.0,M,-33.7,M,0.0,0000*56\r\n");
+	GPSLib::SentenceView view;
+	BOOST_REQUIRE(Parse(view, s));
+
+	boost::posix_time::time_duration time;
+	double value;
+	int quality;
+	BOOST_REQUIRE(!view.GetTime(GPSLib::GGAFields::Time, time));
+	BOOST_REQUIRE(!view.GetLatLng(GPSLib::GGAFields::Latitude, value));
+	BOOST_REQUIRE(view.GetLatLng(GPSLib::GGAFields::Longitude, value));
+	BOOST_REQUIRE(!view.GetInt(GPSLib::GGAFields::Quality, quality));
+	BOOST_REQUIRE(!view.GetDouble(GPSLib::GGAFields::HorizontalDilution, value));
+}
+
+BOOST_AUTO_TEST_CASE(SentenceViewLatLngRangeTest)
+{
+	// 60 minutes and 181 degrees are refused by both overloads - no checksum, so the fields can be anything
+	GPSLib::SentenceView view;
+	double degrees;
+	GPSLib::FixedCoordinate fixed;
+	BOOST_REQUIRE(Parse(view, "$GPRMC,191630.609,A,3860.0000,N,18100.0000,W,31.464734,56.21,150113,,\r\n"));
+	BOOST_REQUIRE(!view.GetLatLng(GPSLib::RMCFields::Latitude, degrees));
+	BOOST_REQUIRE(!view.GetLatLng(GPSLib::RMCFields::Latitude, fixed));
+	BOOST_REQUIRE(!view.GetLatLng(GPSLib::RMCFields::Longitude, degrees));
+	BOOST_REQUIRE(!view.GetLatLng(GPSLib::RMCFields::Longitude, fixed));
+
+	BOOST_REQUIRE(Parse(view, "$GPRMC,191630.609,A,3859.9999,N,18000.0000,W,31.464734,56.21,150113,,\r\n"));
+	BOOST_REQUIRE(view.GetLatLng(GPSLib::RMCFields::Latitude, degrees));
+	BOOST_REQUIRE(view.GetLatLng(GPSLib::RMCFields::Latitude, fixed));
+	BOOST_REQUIRE(view.GetLatLng(GPSLib::RMCFields::Longitude, degrees));
+	BOOST_REQUIRE_CLOSE(-180.0, degrees, 1e-9);
+	BOOST_REQUIRE(view.GetLatLng(GPSLib::RMCFields::Longitude, fixed));
+}
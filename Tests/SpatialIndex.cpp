@@ -0,0 +1,114 @@
+#include <boost/test/auto_unit_test.hpp>
+#include <set>
+#include <algorithm>
+#include <cstdlib>
+#include <boost/lexical_cast.hpp>
+#include "../GPSLib/SpatialIndex.h"
+#include "../GPSLib/Geodesy.h"
+
+namespace {
+	std::set<std::string> IDs(const std::vector<GPSLib::SpatialMatch> &matches) {
+		std::set<std::string> ids;
+		for (size_t i = 0; i < matches.size(); i++)
+			ids.insert(matches[i]._sensorID);
+		return ids;
+	}
+
+	// sensors scattered over about 20km around a point, with a few far away to make the grid sparse
+	class Fleet {
+	public:
+		std::vector<std::string> _ids;
+		std::vector<double> _lat, _lon;
+
+		explicit Fleet(GPSLib::SpatialIndex &index) {
+			std::srand(42);
+			for (int i = 0; i < 2000; i++) {
+				_ids.push_back(boost::lexical_cast<std::string>(i));
+				_lat.push_back(38.8 + (std::rand() / static_cast<double>(RAND_MAX) - 0.5) * 0.2);
+				_lon.push_back(-90.3 + (std::rand() / static_cast<double>(RAND_MAX) - 0.5) * 0.2);
+			}
+			for (int i = 0; i < 10; i++) {
+				_ids.push_back("far" + boost::lexical_cast<std::string>(i));
+				_lat.push_back(-40.0 + i);
+				_lon.push_back(170.0 + i);
+			}
+			for (size_t i = 0; i < _ids.size(); i++)
+				index.Update(_ids[i], _lat[i], _lon[i]);
+		}
+	};
+}
+
+BOOST_AUTO_TEST_CASE(SpatialIndexRadiusTest)
+{
+	GPSLib::SpatialIndex index;
+	const Fleet fleet(index);
+	BOOST_REQUIRE_EQUAL(fleet._ids.size(), index.GetSize());
+
+	const double radii[] = { 100.0, 500.0, 2000.0, 20000.0 };
+	for (int r = 0; r < 4; r++) {
+		std::set<std::string> expected;
+		for (size_t i = 0; i < fleet._ids.size(); i++)
+			if (GPSLib::HaversineDistance(38.8, -90.3, fleet._lat[i], fleet._lon[i]) <= radii[r])
+				expected.insert(fleet._ids[i]);
+
+		std::vector<GPSLib::SpatialMatch> matches;
+		index.InRadius(38.8, -90.3, radii[r], matches);
+		BOOST_REQUIRE(expected == IDs(matches));
+		for (size_t i = 0; i < matches.size(); i++)
+			BOOST_REQUIRE(matches[i]._distance <= radii[r]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(SpatialIndexNearestTest)
+{
+	GPSLib::SpatialIndex index;
+	const Fleet fleet(index);
+
+	const size_t ks[] = { 1, 10, 100, 3000 };
+	for (int t = 0; t < 4; t++) {
+		std::vector<double> distances;
+		for (size_t i = 0; i < fleet._ids.size(); i++)
+			distances.push_back(GPSLib::HaversineDistance(38.81, -90.31, fleet._lat[i], fleet._lon[i]));
+		std::sort(distances.begin(), distances.end());
+
+		std::vector<GPSLib::SpatialMatch> matches;
+		index.Nearest(38.81, -90.31, ks[t], matches);
+		BOOST_REQUIRE_EQUAL(std::min(ks[t], fleet._ids.size()), matches.size());
+		for (size_t i = 0; i < matches.size(); i++)
+			BOOST_REQUIRE_CLOSE(distances[i], matches[i]._distance, 1e-9);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(SpatialIndexBoxTest)
+{
+	GPSLib::SpatialIndex index(1.0);
+	index.Update("a", 10.5, 179.5);
+	index.Update("b", 10.5, -179.5);
+	index.Update("c", 10.5, 0);
+	index.Update("d", 20.5, 179.5);
+
+	// across 180
+	std::vector<GPSLib::SpatialMatch> matches;
+	index.InBox(10, 179, 11, -179, matches);
+	std::set<std::string> expected;
+	expected.insert("a");
+	expected.insert("b");
+	BOOST_REQUIRE(expected == IDs(matches));
+
+	// moved out, and another in
+	index.Update("a", 30, 30);
+	index.Update("d", 10.2, 179.9);
+	matches.clear();
+	index.InBox(10, 179, 11, -179, matches);
+	expected.erase("a");
+	expected.insert("d");
+	BOOST_REQUIRE(expected == IDs(matches));
+	BOOST_REQUIRE_EQUAL(4, index.GetSize());
+
+	// the second nearest is across 180
+	matches.clear();
+	index.Nearest(10.5, -179.6, 2, matches);
+	BOOST_REQUIRE_EQUAL(2, matches.size());
+	BOOST_REQUIRE_EQUAL("b", matches[0]._sensorID);
+	BOOST_REQUIRE_EQUAL("d", matches[1]._sensorID);
+}
@@ -1,5 +1,7 @@
 #include <boost/test/auto_unit_test.hpp>
+#include <cctype>
 #include "../GPSLib/Util.h"
+#include "../GPSLib/CharClass.h"
 
 BOOST_AUTO_TEST_CASE(LexicalCastDefaultEmptyTest) 
 {
@@ -21,6 +23,20 @@ BOOST_AUTO_TEST_CASE(HexConvert)
 	BOOST_REQUIRE_EQUAL(240, boost::lexical_cast<GPSLib::byte_from_hex>("F0"));
 }
 
+BOOST_AUTO_TEST_CASE(CharTablesTest) 
+{
+	// the same as the C library in the "C" locale, for every byte
+	for (int c = 0; c < 256; c++) {
+		BOOST_REQUIRE_EQUAL(std::isdigit(c) != 0, GPSLib::IsDigit(c));
+		BOOST_REQUIRE_EQUAL(std::isdigit(c) ? c - '0' : -1, GPSLib::DigitValue(c));
+		BOOST_REQUIRE_EQUAL(std::isxdigit(c) != 0, GPSLib::HexValue(c) >= 0);
+		BOOST_REQUIRE_EQUAL((std::isprint(c) != 0) || (c == '\r') || (c == '\n'), GPSLib::IsNMEAChar(c));
+	}
+	BOOST_REQUIRE_EQUAL(15, GPSLib::HexValue('f'));
+	BOOST_REQUIRE_EQUAL(240, (GPSLib::HexValue('F') << 4) | GPSLib::HexValue('0'));
+	BOOST_REQUIRE(!GPSLib::IsNMEAChar('\xB5'));  // UBX sync
+}
+
 
 #include <boost/regex.hpp>
 #include <boost/date_time.hpp>
@@ -0,0 +1,46 @@
+#include <boost/test/auto_unit_test.hpp>
+#include "../GPSLib/TopicStatistics.h"
+
+BOOST_AUTO_TEST_CASE(TopicStatisticsLatencyTest)
+{
+	GPSLib::TopicStatistics s;
+	for (int i = 100; i >= 1; i--)  // out of order
+		s.Add("a", 0, i);
+	const GPSLib::TopicSummary summary = s.Take();
+	BOOST_REQUIRE_EQUAL(100, summary._samples);
+	BOOST_REQUIRE_EQUAL(50, summary._latency50);
+	BOOST_REQUIRE_EQUAL(90, summary._latency90);
+	BOOST_REQUIRE_EQUAL(99, summary._latency99);
+	BOOST_REQUIRE_EQUAL(100, summary._latencyMax);
+	BOOST_REQUIRE(summary._rate > 0);
+	BOOST_REQUIRE_EQUAL(0, summary._gaps);
+
+	// each period starts afresh
+	const GPSLib::TopicSummary empty = s.Take();
+	BOOST_REQUIRE_EQUAL(0, empty._samples);
+	BOOST_REQUIRE_EQUAL(0, empty._latencyMax);
+}
+
+BOOST_AUTO_TEST_CASE(TopicStatisticsGapTest)
+{
+	GPSLib::TopicStatistics s;
+	s.Add("a", 1, 1);
+	s.Add("b", 7, 1);  // each sensor numbers its own
+	s.Add("a", 2, 1);
+	s.Add("a", 5, 1);  // 3 and 4 missing
+	s.Add("b", 8, 1);
+	s.Add("a", 6, 1);
+	s.Add("a", 9, 1);  // 7 and 8
+	s.Add("a", 1, 1);  // restarted
+	s.Add("a", 2, 1);
+	GPSLib::TopicSummary summary = s.Take();
+	BOOST_REQUIRE_EQUAL(9, summary._samples);
+	BOOST_REQUIRE_EQUAL(2, summary._gaps);
+	BOOST_REQUIRE_EQUAL(4, summary._missing);
+
+	// sequence numbers carry across periods
+	s.Add("a", 4, 1);
+	summary = s.Take();
+	BOOST_REQUIRE_EQUAL(1, summary._gaps);
+	BOOST_REQUIRE_EQUAL(1, summary._missing);
+}
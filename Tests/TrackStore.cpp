@@ -0,0 +1,94 @@
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/thread.hpp>
+#include "../GPSLib/TrackStore.h"
+
+namespace {
+	const boost::posix_time::ptime start(boost::gregorian::date(2013, 1, 15), boost::posix_time::hours(1));
+
+	GPSLib::TrackPoint Point(int second) {
+		return GPSLib::TrackPoint(start + boost::posix_time::seconds(second), 38.8 + second * 0.001, -90.3, 130 + second, 5, 90);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TrackStoreQueryTest)
+{
+	GPSLib::TrackStore store;
+	GPSLib::TrackPoint latest;
+	BOOST_REQUIRE(!store.GetLatest("a", latest));
+
+	for (int i = 0; i < 10; i++)
+		BOOST_REQUIRE(store.Add("a", Point(i)));
+	BOOST_REQUIRE(store.Add("b", Point(100)));
+
+	BOOST_REQUIRE(store.GetLatest("a", latest));
+	BOOST_REQUIRE(latest._time == Point(9)._time);
+	BOOST_REQUIRE_EQUAL(139, latest._altitude);
+
+	std::vector<GPSLib::TrackPoint> points;
+	store.GetRange("a", Point(3)._time, Point(6)._time, points);  // to is excluded
+	BOOST_REQUIRE_EQUAL(3, points.size());
+	BOOST_REQUIRE(points[0]._time == Point(3)._time);
+	BOOST_REQUIRE(points[2]._time == Point(5)._time);
+
+	points.clear();
+	store.GetRange("a", Point(20)._time, Point(30)._time, points);
+	BOOST_REQUIRE(points.empty());
+
+	store.GetTrack("a", points);
+	BOOST_REQUIRE_EQUAL(10, points.size());
+	BOOST_REQUIRE_EQUAL(2, store.GetSensors().size());
+	BOOST_REQUIRE_EQUAL(11, store.GetSampleCount());
+
+	// no newer than the latest
+	BOOST_REQUIRE(!store.Add("a", Point(9)));
+	BOOST_REQUIRE(!store.Add("a", Point(4)));
+	BOOST_REQUIRE_EQUAL(2, store.GetRejected());
+}
+
+BOOST_AUTO_TEST_CASE(TrackStoreExpiryTest)
+{
+	// samples more than a minute older than the latest go, as do those beyond 100 a sensor
+	GPSLib::TrackStore store(boost::posix_time::minutes(1), 100);
+	for (int i = 0; i < 90; i++)
+		store.Add("a", Point(i));
+
+	std::vector<GPSLib::TrackPoint> points;
+	store.GetTrack("a", points);
+	BOOST_REQUIRE_EQUAL(61, points.size());
+	BOOST_REQUIRE(points.front()._time == Point(29)._time);
+
+	for (int i = 0; i < 300; i++)
+		store.Add("b", GPSLib::TrackPoint(start + boost::posix_time::milliseconds(i * 100), 0, 0, 0, 0, 0));
+	points.clear();
+	store.GetTrack("b", points);
+	BOOST_REQUIRE_EQUAL(100, points.size());
+	BOOST_REQUIRE(points.front()._time == start + boost::posix_time::milliseconds(200 * 100));
+}
+
+BOOST_AUTO_TEST_CASE(TrackStoreThreadsTest)
+{
+	// a writer per sensor while others query - every sample kept, and every range read in order
+	GPSLib::TrackStore store(boost::posix_time::hours(1));
+	bool ordered = true;
+	boost::thread_group threads;
+	for (int t = 0; t < 4; t++) {
+		const std::string sensorID(1, static_cast<char>('a' + t));
+		threads.create_thread([&store, sensorID]() {
+			for (int i = 0; i < 2000; i++)
+				store.Add(sensorID, Point(i));
+		});
+		threads.create_thread([&store, &ordered, sensorID]() {
+			for (int i = 0; i < 200; i++) {
+				std::vector<GPSLib::TrackPoint> points;
+				store.GetRange(sensorID, Point(100)._time, Point(1000)._time, points);
+				for (size_t j = 1; j < points.size(); j++)
+					if (points[j]._time <= points[j-1]._time)
+						ordered = false;
+			}
+		});
+	}
+	threads.join_all();
+
+	BOOST_REQUIRE(ordered);
+	BOOST_REQUIRE_EQUAL(4 * 2000, store.GetSampleCount());
+}
@@ -0,0 +1,177 @@
+#include <boost/test/auto_unit_test.hpp>
+#include "../GPSLib/UBX.h"
+#include "../GPSLib/NMEAGenerator.h"
+#include "../GPSLib/GPSSentenceDecoder.h"
+
+BOOST_AUTO_TEST_CASE(UBXFramerTest)
+{
+	// CFG-MSG poll for NAV-PVT, as in the u-blox protocol specification
+	std::vector<unsigned char> payload;
+	payload.push_back(GPSLib::UBX_NAV);
+	payload.push_back(GPSLib::UBX_NAV_PVT);
+	const std::vector<unsigned char> frame(GPSLib::MakeUBXFrame(GPSLib::UBX_CFG, GPSLib::UBX_CFG_MSG, payload));
+	const unsigned char expected[] = { 0xB5, 0x62, 0x06, 0x01, 0x02, 0x00, 0x01, 0x07, 0x11, 0x3A };
+	BOOST_REQUIRE_EQUAL_COLLECTIONS(expected, expected + sizeof(expected), frame.begin(), frame.end());
+
+	GPSLib::UBXFramer framer;
+	for (size_t i = 0; i < frame.size() - 1; i++)
+		BOOST_REQUIRE_EQUAL(GPSLib::UBXFramer::Framing, framer.Add(frame[i]));
+	BOOST_REQUIRE_EQUAL(GPSLib::UBXFramer::Complete, framer.Add(frame.back()));
+	BOOST_REQUIRE_EQUAL(frame.size(), framer.GetLength());
+	BOOST_REQUIRE(std::equal(frame.begin(), frame.end(), framer.GetFrame()));
+
+	// a bad checksum
+	for (size_t i = 0; i < frame.size() - 1; i++)
+		framer.Add(frame[i]);
+	BOOST_REQUIRE_EQUAL(GPSLib::UBXFramer::Invalid, framer.Add(frame.back() + 1));
+	BOOST_REQUIRE(!framer.IsFraming());
+
+	// Sync1 that isn't followed by Sync2
+	BOOST_REQUIRE_EQUAL(GPSLib::UBXFramer::Framing, framer.Add(GPSLib::UBXFramer::Sync1));
+	BOOST_REQUIRE_EQUAL(GPSLib::UBXFramer::NotUBX, framer.Add('$'));
+	BOOST_REQUIRE(!framer.IsFraming());
+}
+
+BOOST_AUTO_TEST_CASE(MixedUBXAndNMEATest)
+{
+	// UBX frames between sentences decode to the same handlers as the sentences, and neither disturbs the other
+	GPSLib::NMEAGenerator g(38.8048, -90.3070, 30.0, 45.0);
+	std::string s("$GPGGA,191630.609,3848.2905,N,09018.4239,W,1,06,1.3,132.0,M,-33.7,M,0.0,0000*48\r\n");
+	g.NextUBXEpoch(s);
+	s += static_cast<char>(GPSLib::UBXFramer::Sync1);  // noise
+	s += "$GPRMC,191630.609,A,3848.2905,N,09018.4239,W,31.464734,56.21,150113,,*14\r\n";
+
+	boost::asio::io_service ios;
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);  // so shared_from_this() will work
+	int numGGA = 0, numRMC = 0, numGSV = 0, numGSA = 0, numUBX = 0;
+	bool onInvalidSentenceCalled = false;
+	d->OnGGA = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double lat, double lng, int quality, int numSatellites, double horizontalDilution, double altitude) {
+		if (numGGA++ == 1) {
+			BOOST_REQUIRE_EQUAL(boost::posix_time::duration_from_string("19:00:00.000"), time);
+			BOOST_REQUIRE_CLOSE(38.8048, lat, 0.0001);
+			BOOST_REQUIRE_CLOSE(-90.3070, lng, 0.0001);
+			BOOST_REQUIRE_EQUAL(1, quality);
+			BOOST_REQUIRE_EQUAL(6, numSatellites);
+			BOOST_REQUIRE_CLOSE(1.3, horizontalDilution, 0.01);
+			BOOST_REQUIRE_CLOSE(132.0, altitude, 0.01);
+		}
+	};
+	d->OnRMC = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double lat, double lng, double speed, double course, boost::gregorian::date date, const std::string &validity) {
+		numRMC++;
+		BOOST_REQUIRE_EQUAL("A", validity);
+		BOOST_REQUIRE_EQUAL(boost::gregorian::date(2013, 1, 15), date);
+		if (numRMC == 1) {
+			BOOST_REQUIRE_CLOSE(30.0, speed, 0.01);
+			BOOST_REQUIRE_CLOSE(45.0, course, 0.01);
+		}
+	};
+	d->OnGSV = [&](boost::asio::io_service &ios, int totalMessages, int messageNumber, int totalSatellitesInView, const std::vector<GPSLib::SatelliteInfo> &satelliteInfo) {
+		numGSV++;
+		BOOST_REQUIRE_EQUAL(1, totalMessages);
+		BOOST_REQUIRE_EQUAL(1, messageNumber);
+		BOOST_REQUIRE_EQUAL(10, totalSatellitesInView);
+		BOOST_REQUIRE_EQUAL(10, satelliteInfo.size());
+		BOOST_REQUIRE_EQUAL(18, satelliteInfo[0]._prn);
+		BOOST_REQUIRE_EQUAL(62, satelliteInfo[0]._elevation);
+		BOOST_REQUIRE_EQUAL(37, satelliteInfo[0]._snr);
+	};
+	d->OnGSA = [&](boost::asio::io_service &ios, const std::string &mode, int fix, const std::vector<int> &satellitesInView, double pdop, double hdop, double vdop) {
+		numGSA++;
+		BOOST_REQUIRE_EQUAL(3, fix);
+		BOOST_REQUIRE_EQUAL(6, satellitesInView.size());
+		BOOST_REQUIRE_CLOSE(1.3, hdop, 0.01);
+		BOOST_REQUIRE_CLOSE(1.8, vdop, 0.01);
+	};
+	d->OnUBX = [&](boost::asio::io_service &ios, const std::vector<unsigned char> &frame) {
+		numUBX++;
+	};
+	d->OnInvalidSentence = [&](boost::asio::io_service &ios, const std::string &s) {
+		onInvalidSentenceCalled = true;
+	};
+
+	// a byte at a time, so frames and sentences are split everywhere
+	for (size_t i = 0; i < s.size(); i++)
+		d->AddBytes(ios, std::vector<unsigned char>(1, s[i]));
+	ios.run();
+
+	BOOST_REQUIRE(!onInvalidSentenceCalled);
+	BOOST_REQUIRE_EQUAL(3, numUBX);  // NAV-DOP, NAV-PVT, NAV-SAT
+	BOOST_REQUIRE_EQUAL(2, numGGA);
+	BOOST_REQUIRE_EQUAL(2, numRMC);
+	BOOST_REQUIRE_EQUAL(1, numGSV);
+	BOOST_REQUIRE_EQUAL(1, numGSA);
+}
+
+
+namespace {
+	void PutLE(std::vector<unsigned char> &payload, size_t offset, unsigned int value, size_t size) {
+		for (size_t i = 0; i < size; i++)
+			payload[offset + i] = (value >> (8 * i)) & 0xFF;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(NavPVTInvalidDateTest)
+{
+	// a NAV-PVT flagged as having a valid date, for 30 February
+	std::vector<unsigned char> payload(92, 0);
+	PutLE(payload, 4, 2013, 2);
+	payload[6] = 2;
+	payload[7] = 30;
+	payload[8] = 19;
+	payload[11] = 0x03;  // date and time valid
+	PutLE(payload, 16, static_cast<unsigned int>(-5000), 4);  // nano, just before the second
+	payload[20] = 3;
+	payload[21] = 0x01;
+
+	GPSLib::UBXNavPVT pvt;
+	BOOST_REQUIRE(!GPSLib::DecodeNavPVT(&payload[0], payload.size(), pvt));
+
+	// is rejected by the decoder rather than throwing out of it
+	const std::vector<unsigned char> frame(GPSLib::MakeUBXFrame(GPSLib::UBX_NAV, GPSLib::UBX_NAV_PVT, payload));
+	boost::asio::io_service ios;
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);
+	int numRMC = 0;
+	d->OnRMC = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double lat, double lng, double speed, double course, boost::gregorian::date date, const std::string &validity) {
+		numRMC++;
+	};
+	d->AddBytes(ios, frame);
+	BOOST_REQUIRE_NO_THROW(ios.run());
+	BOOST_REQUIRE_EQUAL(0, numRMC);
+	BOOST_REQUIRE_EQUAL(1, d->GetRejected(GPSLib::RR_BAD_FIELD));
+
+	// the 28th is fine, and the negative fraction is taken as the start of the second
+	payload[7] = 28;
+	BOOST_REQUIRE(GPSLib::DecodeNavPVT(&payload[0], payload.size(), pvt));
+	BOOST_REQUIRE_EQUAL(0, pvt._nano);
+}
+
+BOOST_AUTO_TEST_CASE(NavPVTInvalidTimeTest)
+{
+	// a 3D fix with a valid date but no valid time
+	std::vector<unsigned char> payload(92, 0);
+	PutLE(payload, 4, 2013, 2);
+	payload[6] = 1;
+	payload[7] = 15;
+	payload[8] = 19;
+	payload[11] = 0x01;  // date valid only
+	payload[20] = 3;
+	payload[21] = 0x01;
+
+	// is reported as no fix, so nothing is stamped with the receiver's guess at the time
+	const std::vector<unsigned char> frame(GPSLib::MakeUBXFrame(GPSLib::UBX_NAV, GPSLib::UBX_NAV_PVT, payload));
+	boost::asio::io_service ios;
+	const boost::shared_ptr<GPSLib::GPSSentenceDecoder> d(new GPSLib::GPSSentenceDecoder);
+	int numGGA = 0, numRMC = 0;
+	d->OnGGA = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double lat, double lng, int quality, int numSatellites, double horizontalDilution, double altitude) {
+		numGGA++;
+		BOOST_REQUIRE_EQUAL(0, quality);
+	};
+	d->OnRMC = [&](boost::asio::io_service &ios, boost::posix_time::time_duration time, double lat, double lng, double speed, double course, boost::gregorian::date date, const std::string &validity) {
+		numRMC++;
+		BOOST_REQUIRE_EQUAL("V", validity);
+	};
+	d->AddBytes(ios, frame);
+	ios.run();
+	BOOST_REQUIRE_EQUAL(1, numGGA);
+	BOOST_REQUIRE_EQUAL(1, numRMC);
+}
@@ -17,9 +17,28 @@ use strict;
 my $portWriter = "\\\\.\\CNCA0";
 my $portReader = "\\\\.\\CNCB0";
 
-if ($#ARGV == 1) {
-	$portWriter = $ARGV[0];
-	$portReader = $ARGV[1];
+# -qos default|low-latency|reliable picks the QoS profile of both publisher and subscriber, and -transport tcp|rtps|shmem
+# their transport - rtps uses RTPS discovery in place of DCPSInfoRepo - and -waitset n has the subscriber read with n
+# threads of its own in place of listeners
+my $qos = "default";
+my $transport = "tcp";
+my $waitset = 0;
+my @ports;
+for (my $i = 0; $i <= $#ARGV; $i++) {
+	if ($ARGV[$i] eq "-qos") {
+		$qos = $ARGV[++$i];
+	} elsif ($ARGV[$i] eq "-transport") {
+		$transport = $ARGV[++$i];
+	} elsif ($ARGV[$i] eq "-waitset") {
+		$waitset = $ARGV[++$i];
+	} else {
+		push(@ports, $ARGV[$i]);
+	}
+}
+
+if ($#ports == 1) {
+	$portWriter = $ports[0];
+	$portReader = $ports[1];
 }
 
 # must write to the first port, read from the second port
@@ -31,7 +50,11 @@ my $dataPath = abs_path(File::Spec->catfile($dirname, "gps_2013-01-15_0106"));
 print $dataPath . "\n";
 
 my $status = 0;
-my $common_opts = "-ORBDebugLevel 10 -DCPSDebugLevel 10";
+my $common_opts = "-ORBDebugLevel 10 -DCPSDebugLevel 10 -q $qos";
+if ($transport ne "tcp") {
+	$common_opts = $common_opts . " -DCPSConfigFile " . abs_path(File::Spec->catfile($dirname, "$transport.ini"));
+}
+my $useRepo = ($transport ne "rtps");
 
 # my $pub_opts = "$common_opts -ORBLogFile publisher.log -p \\\\.\\COM16 -b 4800";
 my $writer_opts = "-p " . $portWriter;
@@ -43,6 +66,9 @@ $pub_opts = $pub_opts . " $common_opts -ORBLogFile publisher.log ";
 
 my $sub_opts = "$common_opts -DCPSTransportDebugLevel 6 " .
                "-ORBLogFile subscriber.log";
+if ($waitset > 0) {
+	$sub_opts = $sub_opts . " -w $waitset";
+}
 
 my $dcpsrepo_ior = "repo.ior";
 
@@ -57,12 +83,14 @@ my $Writer = PerlDDS::create_process ("SerialWriter", " $writer_opts");
 my $Subscriber = PerlDDS::create_process ("GPSSubscriber", " $sub_opts");
 my $Publisher = PerlDDS::create_process ("GPSPublisher", " $pub_opts");
 
-print $DCPSREPO->CommandLine() . "\n";
-$DCPSREPO->Spawn ();
-if (PerlACE::waitforfile_timed ($dcpsrepo_ior, 30) == -1) {
-    print STDERR "ERROR: waiting for Info Repo IOR file\n";
-    $DCPSREPO->Kill ();
-    exit 1;
+if ($useRepo) {
+    print $DCPSREPO->CommandLine() . "\n";
+    $DCPSREPO->Spawn ();
+    if (PerlACE::waitforfile_timed ($dcpsrepo_ior, 30) == -1) {
+        print STDERR "ERROR: waiting for Info Repo IOR file\n";
+        $DCPSREPO->Kill ();
+        exit 1;
+    }
 }
 if ($portWriter ne "none") {
     print $Writer->CommandLine() . "\n";
@@ -93,10 +121,12 @@ if ($SubscriberResult != 0) {
     $status = 1;
 }
 
-my $ir = $DCPSREPO->TerminateWaitKill(5);
-if ($ir != 0) {
-    print STDERR "ERROR: DCPSInfoRepo returned $ir\n";
-    $status = 1;
+if ($useRepo) {
+    my $ir = $DCPSREPO->TerminateWaitKill(5);
+    if ($ir != 0) {
+        print STDERR "ERROR: DCPSInfoRepo returned $ir\n";
+        $status = 1;
+    }
 }
 
 unlink $dcpsrepo_ior;